@@ -20,6 +20,8 @@
 
 #include "platform.h"
 #include "type_name.h"
+#include "type_id.h"
+#include "TypeRegistry.h"
 #include "object.h"
 #include "inherit.h"
 
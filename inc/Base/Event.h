@@ -2,25 +2,38 @@
 
 #include "Base.h"
 
+// per event type latency and throughput statistics, see EventStats.h
+#ifndef AER_EVENT_STATS
+#   define AER_EVENT_STATS 1
+#endif
+
 namespace aer
 {
-    struct Event : public Object
+    struct Event : public inherit<Event, Object>
     {
         virtual ~Event() = default;
 
         bool handled() const { return _handled; }
 
+        static uint64_t now() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+        }
+
         template< typename E, typename T, typename F > 
         bool Dispatch( const T& target, const F& function )
         {
-            if( typeid( *this ) != typeid( E ) ) return false;
+            static_assert( E::type_ancestors.back() == aer::type_id<E>(), "E must derive through aer::inherit<E, base_t>" );
+            if( type_id() != aer::type_id<E>() ) return false;
 
             _handled |= (target->*function)( static_cast<E&>(*this) );
-            LOG_IF_F( WARNING, !_handled, "Unhandled %s", type_name() );
+            LOG_IF_F( WARNING, !_handled, "Unhandled %s", TypeRegistry::instance().name( type_id() ) );
             return _handled;
         }
 
     private:
+        friend struct EventDispatcher;
+
         bool      _handled = false;
     };
 
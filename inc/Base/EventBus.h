@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "EventListener.h"
+#include "JobSystem.h"
+
+namespace aer
+{
+
+enum EventLane : uint8_t
+{
+    EVENT_LANE_HIGH     = 0,
+    EVENT_LANE_NORMAL,
+    EVENT_LANE_LOW,
+    EVENT_LANE_LAST     = EVENT_LANE_LOW + 1
+};
+
+// Routes events to listeners on the shared JobSystem.
+// Each listener is attached as a Channel with its own bounded queue; a channel is handled by at most one
+// job at a time, so its events are delivered serially and in post order. Ready channels wait in
+// priority lanes and every job serves the highest non-empty lane first. A full channel applies its
+// overflow policy to the poster, which is the back-pressure when handlers fall behind.
+class EventBus
+{
+public:
+    using Handler = std::function<void( Event& )>;
+
+    constexpr static size_t DEFAULT_CHANNEL_CAPACITY = 1024;
+    constexpr static size_t DEFAULT_BATCH_SIZE       = 64;
+
+    struct Channel : public inherit<Channel, Object>
+    {
+        const EventLane     lane;
+        EventOverflowPolicy overflowPolicy = EVENT_OVERFLOW_DEFAULT;
+
+        size_t PendingEvents() const noexcept { return _events.size(); }
+        size_t DroppedEvents() const noexcept { return _dropped.load( std::memory_order_relaxed ); }
+
+    protected:
+        friend EventBus;
+        friend inherit;
+
+        Channel( std::function<bool( Event& )> handler, EventLane in_lane, size_t capacity )
+            : lane( in_lane ), _handler( std::move( handler ) ), _events( capacity ) {}
+
+        // returns whether the event was handled, so EventStats can count the unhandled ones
+        std::function<bool( Event& )> _handler;
+        mpsc_queue<EventStorage>    _events;
+        std::atomic_bool            _scheduled = false;
+        std::atomic_bool            _closed    = false;
+        std::atomic<size_t>         _dropped   = 0;
+    };
+
+    explicit EventBus( utils::JobSystem& jobs = utils::JobSystem::instance() );
+            ~EventBus();
+
+    ref_ptr<Channel> Attach( Handler handler, EventLane lane = EVENT_LANE_NORMAL, size_t capacity = DEFAULT_CHANNEL_CAPACITY );
+
+    // the dispatcher is only ever entered by one worker at a time, but must not be modified while attached
+    ref_ptr<Channel> Attach( EventDispatcher& dispatcher, EventLane lane = EVENT_LANE_NORMAL, size_t capacity = DEFAULT_CHANNEL_CAPACITY );
+
+    // pending events of a detached channel are discarded
+    void Detach( Channel& channel ) { channel._closed.store( true, std::memory_order_release ); }
+
+    // safe to call from any thread
+    template< std::derived_from<Event> E >
+    bool Post( Channel& channel, const ref_ptr<E>& event )
+    {
+        if( !event ) return false;
+        return Enqueue( channel, event->type_id(), static_cast<Event*>( event.get() ) );
+    }
+
+    template< std::derived_from<Event> E, typename... Args >
+    bool Emplace( Channel& channel, Args&&... args )
+    {
+        return Enqueue( channel, aer::type_id<E>(), std::in_place_type<E>, std::forward<Args>( args )... );
+    }
+
+    // blocks until no channel has events waiting or in flight
+    void Flush();
+
+    size_t NumWorkers() const noexcept { return _jobs.size(); }
+
+private:
+    template< typename... Args >
+    bool Enqueue( Channel& channel, type_id_t type, Args&&... args )
+    {
+        if( channel._closed.load( std::memory_order_acquire ) ) return false;
+
+        EventStats::Sent( type );
+        while( !channel._events.try_emplace( std::forward<Args>( args )... ) )
+        {
+            if( channel.overflowPolicy != EVENT_OVERFLOW_BLOCK )
+            {
+                EventStats::Dropped( type );
+                channel._dropped.fetch_add( 1, std::memory_order_relaxed );
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        Schedule( channel );
+        return true;
+    }
+
+    void Schedule( Channel& channel );
+    void Ready( ref_ptr<Channel> channel );
+    void Drain( Channel& channel );
+    void Run();
+
+    utils::JobSystem&                                       _jobs;
+    utils::JobCounter                                       _counter;
+    Mutex                                                   _mutex{ "EventBus" };
+    std::array<std::deque<ref_ptr<Channel>>, EVENT_LANE_LAST> _lanes;
+};
+
+} // namespace aer
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "Event.h"
+
+namespace aer
+{
+
+// Stage between the pending queue and the handlers.
+// Coalescers declared per event type collapse events with equal keys into the newest one,
+// filters drop events outright. Both run on the consumer thread over each drained batch.
+struct EventCoalescer
+{
+    using Key       = std::function<uint64_t( const Event& )>;
+    using Merge     = std::function<void( Event& newer, Event& older )>;
+    using Predicate = std::function<bool( const Event& )>;
+    using filter_t  = uint64_t;
+
+    // every pending E supersedes the older ones
+    template< std::derived_from<Event> E >
+    void Coalesce() { Coalesce( aer::type_id<E>(), []( const Event& ) -> uint64_t { return 0; }, nullptr ); }
+
+    // a pending E supersedes older ones with the same key
+    template< std::derived_from<Event> E, typename K > requires std::invocable<K, const E&>
+    void Coalesce( K&& key )
+    {
+        Coalesce( aer::type_id<E>(), [fn = std::forward<K>( key )]( const Event& event ) -> uint64_t { return fn( static_cast<const E&>( event ) ); }, nullptr );
+    }
+
+    // as above, superseded events are folded into the newest through merge( newer, older ) before they are dropped
+    template< std::derived_from<Event> E, typename K, typename M > requires std::invocable<K, const E&> && std::invocable<M, E&, E&>
+    void Coalesce( K&& key, M&& merge )
+    {
+        Coalesce( aer::type_id<E>(), [fn = std::forward<K>( key )]( const Event& event ) -> uint64_t { return fn( static_cast<const E&>( event ) ); },
+                                     [fn = std::forward<M>( merge )]( Event& newer, Event& older ) { fn( static_cast<E&>( newer ), static_cast<E&>( older ) ); } );
+    }
+
+    void     Coalesce( type_id_t type, Key key, Merge merge );
+    bool     RemoveCoalescer( type_id_t type ) { return _coalescers.erase( type ) > 0; }
+
+    // events for which predicate returns false are dropped
+    filter_t AddFilter( Predicate predicate );
+    bool     RemoveFilter( filter_t filter );
+
+    bool     empty() const noexcept { return _coalescers.empty() && _filters.empty(); }
+
+    // nulls out superseded and filtered events, the relative order of survivors is kept
+    void     Process( std::vector<Event*>& batch );
+
+private:
+    struct Coalescer
+    {
+        Key   key;
+        Merge merge;
+    };
+
+    struct Entry
+    {
+        type_id_t type;
+        uint64_t  key;
+        size_t    index;
+
+        auto operator <=> ( const Entry& ) const = default;
+    };
+
+    std::unordered_map<type_id_t, Coalescer>        _coalescers;
+    std::vector<std::pair<filter_t, Predicate>>     _filters;
+    std::vector<Entry>                              _entries;
+    filter_t                                        _nextFilter = 1;
+};
+
+} // namespace aer
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Event.h"
+
+namespace aer
+{
+
+// Type indexed fan-out of events to subscribed handlers.
+// Delivery is a single lookup on the event's dynamic type id, however many types are subscribed.
+// Not synchronised: Subscribe and Unsubscribe must run on the thread that dispatches, which includes
+// handlers during Dispatch. While attached to an EventBus any of its workers dispatches, so change
+// subscriptions from handlers only, or after the channel has been detached and the bus flushed.
+struct EventDispatcher
+{
+    using Handler        = std::function<bool( Event& )>;
+    using subscription_t = uint64_t;
+
+    // handlers returning void are treated as having handled the event, higher priorities run first
+    template< std::derived_from<Event> E, typename F > requires std::invocable<F, E&>
+    subscription_t Subscribe( F&& handler, int priority = 0 )
+    {
+        return Subscribe( aer::type_id<E>(), [fn = std::forward<F>( handler )]( Event& event ) -> bool
+        {
+            if constexpr( std::is_void_v<std::invoke_result_t<F, E&>> ) { fn( static_cast<E&>( event ) ); return true; }
+            else return fn( static_cast<E&>( event ) );
+        }, priority );
+    }
+
+    subscription_t Subscribe( type_id_t type, Handler handler, int priority = 0 );
+    bool           Unsubscribe( subscription_t subscription );
+
+    // handlers may subscribe and unsubscribe, changes take effect from the next Dispatch
+    bool Dispatch( Event& event ) const;
+
+    bool HasSubscribers( type_id_t type ) const { return _subscribers.contains( type ); }
+
+private:
+    struct Subscriber
+    {
+        subscription_t  id;
+        int             priority;
+        Handler         handler;
+    };
+
+    // replaced rather than modified, so a Dispatch in progress keeps the list it started with
+    using Subscribers = std::vector<Subscriber>;
+
+    std::unordered_map<type_id_t, std::shared_ptr<const Subscribers>>   _subscribers;
+    subscription_t                                                      _nextSubscription = 1;
+};
+
+} // namespace aer
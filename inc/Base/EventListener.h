@@ -1,37 +1,136 @@
 #pragma once
 
+#include <thread>
+
 #include "Event.h"
 #include "Base.h"
+#include "EventCoalescer.h"
+#include "EventDispatcher.h"
+#include "EventStats.h"
+#include "EventStorage.h"
+#include "mpsc_queue.h"
+#include "Profiler.h"
 
 namespace aer
 {
 
+enum EventOverflowPolicy : uint8_t
+{
+    EVENT_OVERFLOW_DROP_NEWEST  = 0,    // SendEvent fails and the event is counted as dropped
+    EVENT_OVERFLOW_BLOCK,               // SendEvent yields until the consumer makes room
+    EVENT_OVERFLOW_DEFAULT      = EVENT_OVERFLOW_DROP_NEWEST
+};
+
 template< typename T >
 struct IEventListener
 {
-    template< typename E >
-    requires std::derived_from< E, Event > || std::common_reference_with< E, Event >
-    inline  void SendEvent( E&& event ) { _events.emplace_back( event ); };
+    constexpr static size_t DEFAULT_EVENT_CAPACITY = 1024;
+
+    EventOverflowPolicy overflowPolicy = EVENT_OVERFLOW_DEFAULT;
+
+    explicit IEventListener( size_t capacity = DEFAULT_EVENT_CAPACITY ) : _events( capacity ) {}
+
+    // safe to call from any number of threads, the event is shared with the queue
+    template< std::derived_from<Event> E >
+    inline  bool SendEvent( const ref_ptr<E>& event )
+    {
+        if( !event ) return false;
+        return Enqueue( event->type_id(), static_cast<Event*>( event.get() ) );
+    };
 
-    virtual bool PollEvents( Events& poll_to, bool clear_unhandled = true )
+    // safe to call from any number of threads, small events are constructed inside the queue without allocating
+    template< std::derived_from<Event> E, typename... Args >
+    inline  bool EmplaceEvent( Args&&... args )
     {
-        if( _events.empty() ) return false;
+        return Enqueue( aer::type_id<E>(), std::in_place_type<E>, std::forward<Args>( args )... );
+    }
+
+    // single consumer, hands up to max_events unhandled events to fn( Event& ) in one batch
+    // after coalescing and filtering, events are destroyed once the batch has been handed out
+    template< std::invocable<Event&> F >
+    size_t PollEvents( F&& fn, size_t max_events = SIZE_MAX )
+    {
+        AER_PROFILE_SCOPE( "IEventListener::PollEvents" );
+        if( _coalescer.empty() )
+        {
+            return _events.consume( [&]( EventStorage& event )
+            {
+                if( !event->handled() ) EventStats::Deliver( *event, event.sent(), fn );
+            }, max_events );
+        }
+
+        // the batch stays in the queue until it has been handed out, so nothing is moved or copied
+        _batch.clear();
+        for( size_t i = 0; i < max_events; ++i )
+        {
+            auto event = _events.peek( i );
+            if( !event ) break;
+            _batch.push_back( event->get() );
+        }
+
+        _coalescer.Process( _batch );
+        for( size_t i = 0; i < _batch.size(); ++i )
+        {
+            if( _batch[i] && !_batch[i]->handled() ) EventStats::Deliver( *_batch[i], _events.peek( i )->sent(), fn );
+        }
 
-        _events.remove_if( []( const auto& e ){ return e->handled(); } );
-        poll_to.splice( poll_to.end(), _events );
-        if( clear_unhandled ) _events.clear();
-        return _events.empty();
+        _events.pop( _batch.size() );
+        return _batch.size();
     };
+
+    // coalescers and filters must be configured from the consuming thread
+    template< std::derived_from<Event> E, typename... Args >
+    void Coalesce( Args&&... args ) { _coalescer.template Coalesce<E>( std::forward<Args>( args )... ); }
+
+    EventCoalescer::filter_t AddFilter( EventCoalescer::Predicate predicate ) { return _coalescer.AddFilter( std::move( predicate ) ); }
+    bool                     RemoveFilter( EventCoalescer::filter_t filter )  { return _coalescer.RemoveFilter( filter ); }
+
+    template< std::derived_from<Event> E, typename F >
+    EventDispatcher::subscription_t Subscribe( F&& handler, int priority = 0 )
+    {
+        return _dispatcher.template Subscribe<E>( std::forward<F>( handler ), priority );
+    }
+
+    bool Unsubscribe( EventDispatcher::subscription_t subscription ) { return _dispatcher.Unsubscribe( subscription ); }
+
+    // single consumer, delivers up to max_events queued events to their subscribers
+    size_t DispatchEvents( size_t max_events = SIZE_MAX )
+    {
+        return PollEvents( [&]( Event& event ){ return _dispatcher.Dispatch( event ); }, max_events );
+    }
+
+    size_t DroppedEvents() const noexcept { return _dropped.load( std::memory_order_relaxed ); }
 protected:
     template< typename E, typename F >
     requires std::invocable< F, E >
-    bool OnEvent( E& event ) 
+    bool OnEvent( E& event )
     {
         return F( event );
     }
-    
+
+    template< typename... Args >
+    bool Enqueue( type_id_t type, Args&&... args )
+    {
+        EventStats::Sent( type );
+        while( !_events.try_emplace( std::forward<Args>( args )... ) )
+        {
+            if( overflowPolicy != EVENT_OVERFLOW_BLOCK )
+            {
+                EventStats::Dropped( type );
+                _dropped.fetch_add( 1, std::memory_order_relaxed );
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
 protected:
-    Events _events;
+    mpsc_queue<EventStorage>    _events;
+    EventDispatcher             _dispatcher;
+    EventCoalescer              _coalescer;
+    std::vector<Event*>         _batch;
+    std::atomic<size_t>         _dropped = 0;
 };
 
-} // namespace aer
\ No newline at end of file
+} // namespace aer
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+#include "Event.h"
+#include "histogram.h"
+
+namespace aer
+{
+
+using EventHistogram = LatencyHistogram;
+
+struct EventTypeStats
+{
+    type_id_t       type      = 0;
+    const char*     name      = nullptr;
+    uint64_t        sent      = 0;  // offered to a queue, including dropped ones
+    uint64_t        delivered = 0;  // handed to a handler
+    uint64_t        unhandled = 0;  // delivered to a handler that reported it unhandled, e.g. a dispatcher without subscribers
+    uint64_t        dropped   = 0;  // rejected by a full queue
+    uint64_t        discarded = 0;  // removed by coalescing or filters
+    EventHistogram  queueLatency;   // sent until delivered
+    EventHistogram  handlerTime;
+};
+
+// Process wide per event type counters and histograms.
+// Recording is a handful of relaxed atomic increments into a fixed table, so it can stay on in production;
+// build with AER_EVENT_STATS=0 to compile it out or clear `enabled` to pause it.
+class EventStats
+{
+public:
+    constexpr static size_t MAX_TYPES = 256;
+
+    static inline std::atomic_bool enabled = true;
+
+    // send time kept by the queue entry, not the event, which may be shared by several queues
+    static uint64_t Timestamp() noexcept             { if constexpr( AER_EVENT_STATS ) if( active() ) return Event::now(); return 0; }
+    static void Sent( type_id_t type ) noexcept      { if constexpr( AER_EVENT_STATS ) if( active() ) Count( type, &Slot::sent ); }
+    static void Dropped( type_id_t type ) noexcept   { if constexpr( AER_EVENT_STATS ) if( active() ) Count( type, &Slot::dropped ); }
+    static void Discarded( const Event& event ) noexcept { if constexpr( AER_EVENT_STATS ) if( active() ) Count( event.type_id(), &Slot::discarded ); }
+
+    // runs fn( event ) and records its queue latency since sent and its handler time,
+    // a handler returning bool reports whether it handled the event, others are not counted as unhandled
+    template< typename F >
+    static void Deliver( Event& event, uint64_t sent, F&& fn )
+    {
+        if constexpr( AER_EVENT_STATS )
+        {
+            if( active() )
+            {
+                auto start   = Event::now();
+                bool handled = true;
+                if constexpr( std::is_same_v<std::invoke_result_t<F&, Event&>, bool> ) handled = fn( event );
+                else                                                                  fn( event );
+                Record( event.type_id(), sent, start, Event::now(), handled );
+                return;
+            }
+        }
+        fn( event );
+    }
+
+    static std::vector<EventTypeStats> snapshot();
+    static void                        reset() noexcept;
+
+private:
+    struct Slot
+    {
+        std::atomic<type_id_t>                                  type = 0;
+        std::atomic<uint64_t>                                   sent = 0, delivered = 0, unhandled = 0, dropped = 0, discarded = 0;
+        std::array<std::atomic<uint64_t>, EventHistogram::BUCKETS> queueLatency{}, handlerTime{};
+    };
+
+    static bool  active() noexcept { return enabled.load( std::memory_order_relaxed ); }
+    static Slot* find( type_id_t type ) noexcept;
+    static void  Count( type_id_t type, std::atomic<uint64_t> Slot::* counter ) noexcept;
+    static void  Record( type_id_t type, uint64_t sent, uint64_t start, uint64_t end, bool handled ) noexcept;
+
+    static std::array<Slot, MAX_TYPES> _slots;
+};
+
+} // namespace aer
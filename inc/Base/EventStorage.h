@@ -0,0 +1,55 @@
+#pragma once
+
+#include <new>
+#include <utility>
+
+#include "Event.h"
+#include "EventStats.h"
+
+namespace aer
+{
+
+// Owns a single event by value.
+// Events that fit INLINE_SIZE are constructed in the internal buffer, larger ones fall back to the heap.
+// Objects can not be moved, so storage is pinned and built in place, e.g. in an mpsc_queue cell.
+// Handlers receive inline events by reference and must not retain them in a ref_ptr.
+// The storage keeps the send time for EventStats, so an event shared by several queues is never written.
+class EventStorage
+{
+public:
+    constexpr static size_t INLINE_SIZE      = 64;
+    constexpr static size_t INLINE_ALIGNMENT = alignof( std::max_align_t );
+
+    template< typename E >
+    constexpr static bool fits_inline = sizeof( E ) <= INLINE_SIZE && alignof( E ) <= INLINE_ALIGNMENT;
+
+    template< std::derived_from<Event> E, typename... Args >
+    explicit EventStorage( std::in_place_type_t<E>, Args&&... args ) : _sent( EventStats::Timestamp() )
+    {
+        if constexpr( fits_inline<E> ) _event = ::new( _buffer ) E( std::forward<Args>( args )... );
+        else                           _event = ( _heap = ref_ptr<Event>( new E( std::forward<Args>( args )... ) ) ).get();
+    }
+
+    explicit EventStorage( Event* event ) : _event( event ), _heap( event ), _sent( EventStats::Timestamp() ) {}
+
+    ~EventStorage() { if( _event && is_inline() ) _event->~Event(); }
+
+    EventStorage( const EventStorage& )              = delete;
+    EventStorage& operator = ( const EventStorage& ) = delete;
+
+    Event&       operator *  ()       noexcept { return *_event; }
+    Event*       operator -> ()       noexcept { return  _event; }
+    Event*       get()                noexcept { return  _event; }
+    bool         is_inline()    const noexcept { return !_heap; }
+
+    // steady clock nanoseconds at which the event entered the queue, 0 while EventStats is off
+    uint64_t     sent()         const noexcept { return _sent; }
+
+private:
+    alignas( INLINE_ALIGNMENT ) std::byte _buffer[INLINE_SIZE];
+    Event*                                _event = nullptr;
+    ref_ptr<Event>                        _heap;
+    uint64_t                              _sent = 0;
+};
+
+} // namespace aer
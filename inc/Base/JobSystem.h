@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Mutex.h"
+#include "interfaces/singleton.h"
+#include "thread_utils.h"
+
+namespace aer { namespace utils
+{
+
+class  JobSystem;
+struct JobCounter;
+
+struct alignas( 64 ) Job
+{
+    std::function<void()>   function;
+    JobCounter*             counter = nullptr;
+};
+
+// Counts unfinished jobs; jobs submitted with run_after() start once it drops to zero.
+struct JobCounter
+{
+    size_t pending() const noexcept { return _pending.load( std::memory_order_acquire ); }
+
+private:
+    friend JobSystem;
+
+    std::atomic<size_t> _pending = 0;
+    SpinLock            _mutex{ "utils::JobCounter" };
+    std::vector<Job*>   _continuations;
+};
+
+// Chase-Lev work-stealing deque of fixed capacity.
+// The owning thread pushes and pops at the bottom, any thread steals from the top.
+class JobDeque
+{
+public:
+    constexpr static size_t CAPACITY = 4096;
+
+    bool push( Job* job ) noexcept;
+    Job* pop() noexcept;
+    Job* steal() noexcept;
+
+private:
+    alignas( 64 ) std::atomic<int64_t>  _top    = 0;
+    alignas( 64 ) std::atomic<int64_t>  _bottom = 0;
+    std::atomic<Job*>                   _jobs[CAPACITY]{};
+};
+
+// Shared work-stealing scheduler.
+// Every worker owns a JobDeque, idle workers steal from the others and threads outside the pool
+// submit through a shared injection queue. wait() runs other jobs instead of blocking.
+class JobSystem : public ISingleton<JobSystem>
+{
+public:
+    explicit JobSystem( size_t num_workers = num_threads() - 1 );
+            ~JobSystem();
+
+    void run( JobCounter& counter, std::function<void()> function );
+    // starts function once dependency has no pending jobs, counter tracks it from now on
+    void run_after( JobCounter& dependency, JobCounter& counter, std::function<void()> function );
+    void wait( JobCounter& counter );
+
+    // invokes function( i ) for every i in [begin, end), in chunks of up to grain indices, an empty or
+    // reversed range invokes nothing
+    template< typename F > requires std::invocable<F, size_t>
+    void parallel_for( size_t begin, size_t end, size_t grain, F&& function )
+    {
+        if( begin >= end ) return;
+
+        JobCounter counter;
+        grain = std::max<size_t>( grain, 1 );
+        for( ; end - begin > grain; begin += grain )
+        {
+            run( counter, [&function, first = begin, last = begin + grain]{ for( auto i = first; i < last; ++i ) function( i ); } );
+        }
+        for( auto i = begin; i < end; ++i ) function( i );
+        wait( counter );
+    }
+
+    size_t size() const noexcept { return _workers.size(); }
+    // workers are numbered [0, size()), any other thread is size()
+    size_t worker_index() const noexcept;
+
+private:
+    Job* acquire( std::function<void()>&& function, JobCounter& counter );
+    void submit( Job* job );
+    Job* find( size_t index );
+    void execute( Job* job );
+    void finish( JobCounter& counter );
+    void work( size_t index );
+
+    std::vector<std::unique_ptr<JobDeque>>  _deques;
+    SpinLock                                _injectionMutex{ "utils::JobSystem::injection" };
+    std::deque<Job*>                        _injection;
+    std::vector<std::thread>                _workers;
+
+    std::atomic<size_t>                     _queued   = 0;
+    std::atomic<bool>                       _stopping = false;
+    std::mutex                              _sleepMutex;
+    std::condition_variable                 _wake;
+};
+
+} } // namespace aer::utils
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "histogram.h"
+
+// per named lock wait and hold time statistics, see LockStats
+#ifndef AER_LOCK_STATS
+#   define AER_LOCK_STATS 1
+#endif
+
+namespace aer
+{
+
+struct LockInfo
+{
+    const char*         name         = nullptr;
+    uint64_t            acquisitions = 0;
+    uint64_t            contended    = 0;   // had to wait for another holder
+    uint64_t            parked       = 0;   // gave up spinning and slept
+    LatencyHistogram    waitTime;
+    LatencyHistogram    holdTime;           // empty unless LockStats::holdTimes is set
+};
+
+// Process wide statistics per lock name, every lock constructed with the same name shares one slot.
+// Like EventStats it records into a fixed table with relaxed atomics and never allocates, so the
+// allocator's own locks can report; build with AER_LOCK_STATS=0 to compile it out.
+class LockStats
+{
+public:
+    constexpr static size_t MAX_LOCKS = 128;
+
+    static inline std::atomic_bool enabled = true;
+
+    // hold times cost two clock reads per acquisition, uncontended ones otherwise read none
+    static inline std::atomic_bool holdTimes = false;
+
+    struct Slot
+    {
+        std::atomic<uint64_t>                                       key = 0;
+        std::atomic<const char*>                                    name = nullptr;
+        std::atomic<uint64_t>                                       acquisitions = 0, contended = 0, parked = 0;
+        std::array<std::atomic<uint64_t>, LatencyHistogram::BUCKETS> waitTime{}, holdTime{};
+    };
+
+    // nullptr when stats are compiled out or the table is full
+    static Slot* find( const char* name ) noexcept;
+
+    static std::vector<LockInfo> snapshot();
+    static void                  reset() noexcept;
+
+    static bool     active() noexcept { return AER_LOCK_STATS && enabled.load( std::memory_order_relaxed ); }
+    static uint64_t now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+private:
+    static std::array<Slot, MAX_LOCKS> _slots;
+};
+
+namespace detail
+{
+
+// shared bookkeeping of the lock family, only the holder touches these members
+// the slot is looked up on first acquisition, so locks stay constant initialised like std::mutex
+class InstrumentedLock
+{
+protected:
+    constexpr explicit InstrumentedLock( const char* name ) noexcept : _name( name ) {}
+
+    void acquired( uint64_t waitStart, bool contended, bool parked ) noexcept
+    {
+        _lockedAt = 0;
+        if( !LockStats::active() ) return;
+        if( !_stats && _name ) { _stats = LockStats::find( _name ); _name = nullptr; }
+        if( !_stats ) return;
+
+        _stats->acquisitions.fetch_add( 1, std::memory_order_relaxed );
+        if( contended ) _stats->contended.fetch_add( 1, std::memory_order_relaxed );
+        if( parked )    _stats->parked.fetch_add( 1, std::memory_order_relaxed );
+
+        const bool timed = contended && waitStart;
+        const bool held  = LockStats::holdTimes.load( std::memory_order_relaxed );
+        if( !timed && !held ) return;
+
+        const auto now = LockStats::now();
+        if( timed ) _stats->waitTime[LatencyHistogram::bucket( now - waitStart )].fetch_add( 1, std::memory_order_relaxed );
+        if( held )  _lockedAt = now;
+    }
+
+    void releasing() noexcept
+    {
+        if( _lockedAt ) _stats->holdTime[LatencyHistogram::bucket( LockStats::now() - _lockedAt )].fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    const char*         _name;
+    LockStats::Slot*    _stats    = nullptr;
+    uint64_t            _lockedAt = 0;
+};
+
+} // namespace aer::detail
+
+// Test and test-and-set lock for short critical sections, yields to the scheduler after SPIN_LIMIT tries.
+class SpinLock : private detail::InstrumentedLock
+{
+public:
+    constexpr static size_t SPIN_LIMIT = 64;
+
+    constexpr explicit SpinLock( const char* name = "aer::SpinLock" ) noexcept : InstrumentedLock( name ) {}
+
+    SpinLock( const SpinLock& )              = delete;
+    SpinLock& operator = ( const SpinLock& ) = delete;
+
+    bool try_lock() noexcept
+    {
+        if( _locked.load( std::memory_order_relaxed ) || _locked.exchange( true, std::memory_order_acquire ) ) return false;
+        acquired( 0, false, false );
+        return true;
+    }
+
+    void lock() noexcept
+    {
+        if( !_locked.exchange( true, std::memory_order_acquire ) ) { acquired( 0, false, false ); return; }
+
+        const auto start = LockStats::active() ? LockStats::now() : 0;
+        for( size_t spins = 0; _locked.exchange( true, std::memory_order_acquire ); )
+        {
+            while( _locked.load( std::memory_order_relaxed ) ) if( ++spins > SPIN_LIMIT ) std::this_thread::yield();
+        }
+        acquired( start, true, false );
+    }
+
+    void unlock() noexcept
+    {
+        releasing();
+        _locked.store( false, std::memory_order_release );
+    }
+
+private:
+    std::atomic_bool _locked = false;
+};
+
+// Spins for SPIN_LIMIT tries and then parks on the lock word until the holder wakes it.
+class Mutex : private detail::InstrumentedLock
+{
+public:
+    constexpr static size_t SPIN_LIMIT = 128;
+
+    constexpr explicit Mutex( const char* name = "aer::Mutex" ) noexcept : InstrumentedLock( name ) {}
+
+    Mutex( const Mutex& )              = delete;
+    Mutex& operator = ( const Mutex& ) = delete;
+
+    bool try_lock() noexcept
+    {
+        uint32_t expected = UNLOCKED;
+        if( !_state.compare_exchange_strong( expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed ) ) return false;
+        acquired( 0, false, false );
+        return true;
+    }
+
+    void lock() noexcept
+    {
+        uint32_t expected = UNLOCKED;
+        if( _state.compare_exchange_strong( expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed ) ) { acquired( 0, false, false ); return; }
+
+        const auto start = LockStats::active() ? LockStats::now() : 0;
+        for( size_t spins = 0; spins < SPIN_LIMIT; ++spins )
+        {
+            expected = UNLOCKED;
+            if( _state.load( std::memory_order_relaxed ) == UNLOCKED
+             && _state.compare_exchange_weak( expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed ) ) { acquired( start, true, false ); return; }
+        }
+
+        // announce a sleeper so unlock() knows to wake one, whoever takes the lock from here keeps the flag
+        while( _state.exchange( PARKED, std::memory_order_acquire ) != UNLOCKED ) _state.wait( PARKED, std::memory_order_relaxed );
+        acquired( start, true, true );
+    }
+
+    void unlock() noexcept
+    {
+        releasing();
+        if( _state.exchange( UNLOCKED, std::memory_order_release ) == PARKED ) _state.notify_one();
+    }
+
+private:
+    enum : uint32_t { UNLOCKED = 0, LOCKED = 1, PARKED = 2 };
+
+    std::atomic<uint32_t> _state = UNLOCKED;
+};
+
+} // namespace aer
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <ostream>
+
+#include "thread_utils.h"
+
+// scoped zone profiler, off unless built with AER_PROFILE=1
+#ifndef AER_PROFILE
+#   define AER_PROFILE 0
+#endif
+
+#define AER_PROFILE_CONCAT_IMPL( a, b ) a##b
+#define AER_PROFILE_CONCAT( a, b )      AER_PROFILE_CONCAT_IMPL( a, b )
+
+#if AER_PROFILE
+    // name must outlive the profiler, i.e. be a string literal
+#   define AER_PROFILE_SCOPE( name ) ::aer::ProfileZone AER_PROFILE_CONCAT( _aer_profile_zone_, __LINE__ ){ name }
+#else
+#   define AER_PROFILE_SCOPE( name ) ((void)0)
+#endif
+
+namespace aer
+{
+
+struct ProfileEvent
+{
+    const char* name  = nullptr;
+    uint64_t    begin = 0;  // steady clock nanoseconds
+    uint64_t    end   = 0;
+};
+
+// Records completed zones into one ring per thread and exports them as Chrome trace events.
+// Only the owning thread writes a ring, a zone costs two clock reads and three stores, and the oldest
+// zones are overwritten once a ring is full. An export holds up to RING_CAPACITY - 1 zones per thread,
+// the slot being overwritten next is left out.
+class Profiler
+{
+public:
+    constexpr static size_t RING_CAPACITY = 16384;
+
+    static inline std::atomic_bool enabled = true;
+
+    static uint64_t now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    static void record( const char* name, uint64_t begin, uint64_t end ) noexcept;
+
+    // trace-event JSON for chrome://tracing or Perfetto, safe while other threads keep recording
+    static void write_chrome_trace( std::ostream& stream );
+    static bool save_chrome_trace( const std::filesystem::path& path );
+
+    // drops every recorded zone, must not race with recording threads
+    static void clear() noexcept;
+
+private:
+    // relaxed atomics so the exporter may read entries the owner is overwriting
+    struct Entry
+    {
+        std::atomic<const char*>    name  = nullptr;
+        std::atomic<uint64_t>       begin = 0;
+        std::atomic<uint64_t>       end   = 0;
+    };
+
+    struct Ring
+    {
+        std::atomic<uint64_t>               head = 0;
+        std::array<Entry, RING_CAPACITY>    entries;
+    };
+
+    static utils::PerThread<std::atomic<Ring*>>& rings();
+};
+
+struct ProfileZone
+{
+    explicit ProfileZone( const char* name ) noexcept : _name( name ), _begin( Profiler::enabled.load( std::memory_order_relaxed ) ? Profiler::now() : 0 ) {}
+            ~ProfileZone() { if( _begin ) Profiler::record( _name, _begin, Profiler::now() ); }
+
+    ProfileZone( const ProfileZone& )              = delete;
+    ProfileZone& operator = ( const ProfileZone& ) = delete;
+private:
+    const char* _name;
+    uint64_t    _begin;
+};
+
+} // namespace aer
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "type_id.h"
+#include "type_name.h"
+#include "interfaces/singleton.h"
+
+namespace aer
+{
+
+struct TypeInfo
+{
+    type_id_t           id        = 0;
+    std::string_view    name;
+    std::size_t         size      = 0;
+    std::size_t         alignment = 0;
+};
+
+// Interned mapping of type id to name, size and alignment.
+// Hot paths only carry the type id, names are resolved when output is produced.
+class TypeRegistry : public ISingleton<TypeRegistry>
+{
+public:
+    template< typename T >
+    type_id_t add() { return add( TypeInfo{ aer::type_id<T>(), type_name<T>(), sizeof( T ), alignof( T ) } ); }
+
+    // the name must have static storage duration, as type_name<T>() does
+    type_id_t       add( const TypeInfo& );
+    const TypeInfo* find( type_id_t ) const;
+    const char*     name( type_id_t ) const;
+
+    std::vector<TypeInfo> types() const;
+private:
+    // kept as a reader-writer lock rather than an instrumented Mutex, every name lookup for output is a
+    // reader and writers only appear while types are registered, mostly during static initialisation
+    mutable std::shared_mutex               _mutex;
+    std::unordered_map<type_id_t, TypeInfo> _types;
+};
+
+// registers T once during static initialisation when odr-used
+template< typename T >
+inline const type_id_t registered_type_id = TypeRegistry::instance().add<T>();
+
+} // namespace aer
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+
+#include <loguru.hpp>
+
+#include "thread_utils.h"
+
+// Like LOG_IF_F / DLOG_IF_F, but the call site only copies the format and its raw arguments into a
+// per thread buffer; a background thread formats and hands the message to loguru.
+#define DEFERRED_LOG_IF_F( verbosity_name, cond, ... ) \
+    ( ( cond ) && ::aer::DeferredLog::accepts( loguru::Verbosity_##verbosity_name ) ? ::aer::DeferredLog::log( loguru::Verbosity_##verbosity_name, __FILE__, __LINE__, __VA_ARGS__ ) : (void)0 )
+
+#if LOGURU_DEBUG_LOGGING
+#   define DEFERRED_DLOG_IF_F( verbosity_name, cond, ... ) DEFERRED_LOG_IF_F( verbosity_name, cond, __VA_ARGS__ )
+#else
+#   define DEFERRED_DLOG_IF_F( verbosity_name, cond, ... ) ((void)0)
+#endif
+
+namespace aer
+{
+
+// Deferred formatting logger for hot paths such as memory tracking.
+// Arguments must be trivially copyable and are formatted later, so strings are not accepted; a full
+// buffer drops the message and counts it instead of blocking the caller.
+class DeferredLog
+{
+public:
+    constexpr static size_t ARGUMENTS_SIZE  = 64;
+    constexpr static size_t RING_CAPACITY   = 1024;
+    constexpr static size_t MESSAGE_SIZE    = 512;
+    constexpr static auto   FLUSH_INTERVAL  = std::chrono::milliseconds( 2 );
+
+    static bool accepts( loguru::Verbosity verbosity ) noexcept { return verbosity <= loguru::current_verbosity_cutoff(); }
+
+    template< typename... Args >
+    static void log( loguru::Verbosity verbosity, const char* file, unsigned line, const char* format, Args... args )
+    {
+        using layout = Layout<std::decay_t<Args>...>;
+        static_assert( layout::size <= ARGUMENTS_SIZE, "too many arguments for a deferred message" );
+        static_assert( ( std::is_trivially_copyable_v<std::decay_t<Args>> && ... ), "deferred arguments must be trivially copyable" );
+        static_assert( ( !is_string<std::decay_t<Args>> && ... ), "deferred messages can not hold strings" );
+
+        Record record{ format, file, line, verbosity, &layout::format, 0, {} };
+        [&]<size_t... I>( std::index_sequence<I...> )
+        {
+            ( std::memcpy( record.arguments + layout::offsets[I], &args, sizeof( args ) ), ... );
+        }( std::index_sequence_for<Args...>{} );
+        push( record );
+    }
+
+    // formats everything recorded so far on the calling thread
+    static void flush();
+
+    // stops the background thread after a last flush, later messages are formatted synchronously;
+    // runs at exit and may be called earlier
+    static void shutdown();
+
+    static size_t dropped() noexcept { return _dropped.load( std::memory_order_relaxed ); }
+
+private:
+    using formatter_t = int(*)( char* out, size_t size, const char* format, const std::byte* arguments );
+
+    struct Record
+    {
+        const char*         format;
+        const char*         file;
+        unsigned            line;
+        loguru::Verbosity   verbosity;
+        formatter_t         formatter;
+        utils::thread_index_t thread = 0;
+
+        alignas( std::max_align_t ) std::byte arguments[ARGUMENTS_SIZE];
+    };
+
+    // arguments are packed back to back at aligned offsets
+    template< typename... Args >
+    struct Layout
+    {
+        // one offset per argument followed by the total size
+        constexpr static std::array<size_t, sizeof...( Args ) + 1> offsets = []
+        {
+            std::array<size_t, sizeof...( Args ) + 1> offsets{};
+            size_t offset = 0, i = 0;
+            ( ( offset = ( offset + alignof( Args ) - 1 ) / alignof( Args ) * alignof( Args ), offsets[i++] = offset, offset += sizeof( Args ) ), ... );
+            offsets[i] = offset;
+            return offsets;
+        }();
+        constexpr static size_t size = offsets.back();
+
+        static int format( char* out, size_t size, const char* format, const std::byte* arguments )
+        {
+            return [&]<size_t... I>( std::index_sequence<I...> )
+            {
+                return std::snprintf( out, size, format, load<Args>( arguments + offsets[I] )... );
+            }( std::index_sequence_for<Args...>{} );
+        }
+    };
+
+    // a char pointer would dangle by the time it is formatted, a plain char is copied like any value
+    template< typename T >
+    constexpr static bool is_string = std::is_pointer_v<T> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char>;
+
+    template< typename T >
+    static T load( const std::byte* data ) noexcept { T value; std::memcpy( &value, data, sizeof( T ) ); return value; }
+
+    struct Ring;
+    struct Backend;
+
+    static Backend* backend();
+    static void     push( Record& record ) noexcept;
+    static void     write( const Record& record ) noexcept;
+
+    static inline std::atomic<size_t> _dropped = 0;
+};
+
+} // namespace aer
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace aer
+{
+
+// log2 buckets of nanoseconds, bucket i counts samples in [2^(i-1), 2^i)
+struct LatencyHistogram
+{
+    constexpr static size_t BUCKETS = 48;
+
+    std::array<uint64_t, BUCKETS> counts{};
+
+    static size_t bucket( uint64_t nanoseconds ) noexcept
+    {
+        return std::min<size_t>( std::bit_width( nanoseconds ), BUCKETS - 1 );
+    }
+
+    uint64_t total() const noexcept
+    {
+        uint64_t total = 0;
+        for( auto count : counts ) total += count;
+        return total;
+    }
+
+    // upper bound in nanoseconds of the bucket holding quantile q in [0, 1]
+    uint64_t quantile( double q ) const noexcept
+    {
+        auto total = this->total();
+        if( total == 0 ) return 0;
+
+        auto rank = static_cast<uint64_t>( q * static_cast<double>( total - 1 ) ) + 1;
+        for( size_t i = 0; i < BUCKETS; ++i )
+        {
+            if( counts[i] >= rank ) return uint64_t( 1 ) << i;
+            rank -= counts[i];
+        }
+        return uint64_t( 1 ) << ( BUCKETS - 1 );
+    }
+};
+
+} // namespace aer
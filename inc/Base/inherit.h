@@ -2,6 +2,8 @@
 
 #include "object.h"
 #include "memory/ref_ptr.h"
+#include "TypeRegistry.h"
+#include "memory/ObjectPool.h"
 
 namespace aer
 {
@@ -12,6 +14,15 @@ struct inherit : public base_t
 {
     using Base = base_t;
 
+    static constexpr std::size_t type_depth     = base_t::type_depth + 1;
+    static constexpr auto        type_ancestors = []
+    {
+        std::array<type_id_t, type_depth + 1> ids{};
+        for( std::size_t i = 0; i < base_t::type_ancestors.size(); ++i ) ids[i] = base_t::type_ancestors[i];
+        ids.back() = aer::type_id<derived_t>();
+        return ids;
+    }();
+
     //! constraining this makes the compiler argue that classes are NOT nothrow_destructible
     template< typename... Args > /*requires( std::constructible_from<derived_t, Args...> )*/ static inline
     auto create( Args&&... args )
@@ -19,15 +30,34 @@ struct inherit : public base_t
         return ref_ptr<derived_t>( new derived_t( std::forward<Args>( args )... ) );
     }
 
-    template< typename Self > constexpr
-    bool is_compatible( this Self&&, const std::type_info& type ) noexcept
+    std::span<const type_id_t> type_ids() const noexcept override { return type_ancestors; }
+
+    // pooled types recycle their storage through a thread local freelist, further derived types bypass it
+    static void* operator new( std::size_t size )
     {
-        return typeid( Self ) == type || base_t::is_compatible( type );
+        if constexpr( mem::pooled<derived_t> ) if( size == sizeof( derived_t ) ) return pool::acquire();
+        return base_t::operator new( size );
     }
 
+    static void operator delete( void* ptr, std::size_t size )
+    {
+        if constexpr( mem::pooled<derived_t> ) if( size == sizeof( derived_t ) ) return pool::release( ptr );
+        if constexpr( requires( void* p, std::size_t n ){ base_t::operator delete( p, n ); } ) base_t::operator delete( ptr, size );
+        else                                                                                  base_t::operator delete( ptr );
+    }
+
+    static mem::ObjectPoolStats pool_stats()                        requires mem::pooled<derived_t> { return pool::stats(); }
+    static void                 set_pool_capacity( std::size_t n )  requires mem::pooled<derived_t> { pool::set_capacity( n ); }
+
 protected:
+    using pool = mem::ObjectPool<derived_t, base_t>;
+
     template< typename... Args >
-    inherit( Args&&... args ) : base_t( std::forward<Args>(args)... ) {};
+    inherit( Args&&... args ) : base_t( std::forward<Args>(args)... )
+    {
+        (void)registered_type_id<derived_t>;
+        this->_typeIndex = aer::type_index<derived_t>();
+    };
 
     virtual ~inherit() noexcept = default;
 };
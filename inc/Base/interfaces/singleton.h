@@ -1,22 +1,123 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
 #include <utility>
 
-#include "../memory/ref_ptr.h"
+#include <loguru.hpp>
+
+#include "../Mutex.h"
+#include "../type_name.h"
+
 namespace aer
 {
+namespace detail
+{
+
+// Destroys singletons in reverse order of their creation, so one that used another while being
+// constructed is torn down first. Runs at exit, registered along with the first singleton.
+class SingletonRegistry
+{
+public:
+    constexpr static size_t MAX_SINGLETONS = 64;    // later ones are logged and leaked
+
+    using destroy_t = void(*)() noexcept;
+
+    static void add( destroy_t destroy, const char* name ) noexcept
+    {
+        {
+            std::scoped_lock lock( _mutex );
+            if( !_registered ) _registered = std::atexit( &shutdown ) == 0;
+            if( _count < MAX_SINGLETONS ) { _destroy[_count++] = destroy; return; }
+        }
+        LOG_F( ERROR, "SingletonRegistry::add( %s ) - more than %zu singletons, it is never destroyed.", name, MAX_SINGLETONS );
+    }
+
+    // may also be called early, e.g. before unloading the library
+    static void shutdown() noexcept
+    {
+        for( ;; )
+        {
+            destroy_t destroy;
+            {
+                std::scoped_lock lock( _mutex );
+                if( _count == 0 ) return;
+                destroy = _destroy[--_count];
+            }
+            destroy();
+        }
+    }
+
+private:
+    static inline SpinLock                              _mutex{ "aer::SingletonRegistry" };
+    static inline std::array<destroy_t, MAX_SINGLETONS> _destroy{};
+    static inline size_t                                _count      = 0;
+    static inline bool                                  _registered = false;
+};
 
+} // namespace aer::detail
+
+// Lazily constructed process wide instance of T, handed out as a borrowed reference.
+// After the first call, access is one acquire load; concurrent first callers wait for the one that
+// constructs. A singleton used again after teardown is recreated and never destroyed, which is logged as a warning.
 template< typename T >
 struct ISingleton
 {
+    static T& instance() { return get_or_create(); }
+
+    // the arguments are only used by the call that constructs T
     template< typename... Args >
-    static auto get_or_create( Args&&... args )
+    static T& get_or_create( Args&&... args )
     {
-        if( !_singleton ) _singleton = T::create( std::forward<Args>( args )... );
-        return _singleton;
+        if( auto instance = _instance.load( std::memory_order_acquire ) ) [[likely]] return *instance;
+        return create( std::forward<Args>( args )... );
     }
+
+    // nullptr until constructed and after teardown, never constructs
+    static T* existing() noexcept { return _instance.load( std::memory_order_acquire ); }
+
 protected:
-    static inline ref_ptr<T> _singleton;
+    enum : uint8_t { EMPTY = 0, CREATING, READY, DESTROYED };
+
+    template< typename... Args >
+    [[gnu::noinline]] static T& create( Args&&... args )
+    {
+        auto state = _state.load( std::memory_order_acquire );
+        while( state != READY )
+        {
+            if( state == CREATING ) { _state.wait( CREATING, std::memory_order_acquire ); state = _state.load( std::memory_order_acquire ); continue; }
+            if( !_state.compare_exchange_weak( state, CREATING, std::memory_order_acquire ) ) continue;
+
+            const bool revived = state == DESTROYED;
+            try
+            {
+                _instance.store( new T( std::forward<Args>( args )... ), std::memory_order_release );
+            }
+            catch( ... )
+            {
+                _state.store( state, std::memory_order_release );
+                _state.notify_all();
+                throw;
+            }
+            _state.store( READY, std::memory_order_release );
+            _state.notify_all();
+            if( !revived ) detail::SingletonRegistry::add( &destroy, type_name<T>() );
+            else LOG_F( WARNING, "ISingleton<%s> - used after teardown, the recreated instance is never destroyed.", type_name<T>() );
+            break;
+        }
+        return *_instance.load( std::memory_order_acquire );
+    }
+
+    static void destroy() noexcept
+    {
+        _state.store( DESTROYED, std::memory_order_release );
+        delete _instance.exchange( nullptr, std::memory_order_acq_rel );
+    }
+
+    static inline std::atomic<T*>       _instance = nullptr;
+    static inline std::atomic<uint8_t>  _state    = EMPTY;
 };
 
-} // namespace aer
\ No newline at end of file
+} // namespace aer
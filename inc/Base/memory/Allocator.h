@@ -1,8 +1,15 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
 #include <mutex>
 #include <memory>
+#include <vector>
 
+#include "../Mutex.h"
+#include "../interfaces/singleton.h"
 #include "MemoryTracking.h"
 #include "AllocatorPolicy.h"
 
@@ -19,34 +26,135 @@ enum AllocatorAffinity : uint8_t
 };
 
 struct MemoryBlocks;
+class  Allocator;
+class  Manager;
 
-class Allocator
+// Memory fixed at startup for latency critical processes, see Allocator::make_deterministic().
+struct DeterministicConfig
+{
+    std::array<size_t, ALLOCATOR_AFFINITY_LAST> blocks{};   // preallocated blocks per affinity
+    bool                                        lockPages   = false;    // mlock / VirtualLock the blocks
+    bool                                        allowGrowth = false;
+};
+
+// Bump allocated region for building a subtree in one piece, created through Allocator::create_arena().
+// Freeing a single allocation only counts it, the whole region goes back at once after the arena has
+// been released and its last allocation freed, or when the allocator is destroyed.
+// The counters change under the allocator's lock, used() and live() may be read from any thread.
+struct Arena
+{
+    const AllocatorAffinity affinity;
+    const size_t            capacity;
+
+    size_t used() const noexcept { return _used.load( std::memory_order_relaxed ); }
+    size_t live() const noexcept { return _live.load( std::memory_order_relaxed ); }
+
+private:
+    friend Allocator;
+    Arena( AllocatorAffinity in_affinity, size_t in_capacity ) : affinity( in_affinity ), capacity( in_capacity ) {}
+
+    uint8_t*            _memory   = nullptr;
+    std::atomic<size_t> _used     = 0;
+    std::atomic<size_t> _live     = 0;
+    bool                _released = false;
+};
+
+class Allocator : public ISingleton<Allocator>
 {
 public:
     AllocatorPolicy policy          = ALLOCATOR_POLICY_DEFAULT;
     AllocatorPolicy blockPolicy     = ALLOCATOR_POLICY_STD_NEW_DELETE;
     MemoryTracking  memoryTracking  = MEMORY_TRACKING_DEFAULT;
 
-    Allocator();
+    // called without locks when growth was refused, it may free memory and the allocation is retried once
+    std::function<void( std::size_t size, AllocatorAffinity )> onGrowthFailure;
 
-    static std::unique_ptr<Allocator>& instance() noexcept;
+    Allocator();
+   ~Allocator();
 
-    void* allocate( std::size_t, AllocatorAffinity = ALLOCATOR_AFFINITY_OBJECTS );
+    // hint asks for memory close to an earlier allocation of the same affinity. Only the block policies
+    // (AER_ALLOC_DEALLOC, AER_ACQUIRE_RETIRE) place allocations, so under ALLOCATOR_POLICY_DEFAULT the
+    // hint and PlacementScope are ignored and only arenas keep a subtree together.
+    // Throws std::bad_alloc when the memory budget refuses the growth the allocation needs or, with
+    // growth disabled, when the retry after onGrowthFailure still does not fit, so the class
+    // operator new of Object and Node never hands a constructor nullptr.
+    void* allocate( std::size_t, AllocatorAffinity = ALLOCATOR_AFFINITY_OBJECTS, const void* hint = nullptr );
     bool  deallocate( void*, std::size_t );
+
+    // nullptr when the memory budget refuses the capacity
+    Arena* create_arena( std::size_t capacity, AllocatorAffinity = ALLOCATOR_AFFINITY_NODES );
+    // the arena can no longer be used, its memory is freed with its last allocation
+    void   release_arena( Arena* );
+
+    // gives blocks without live allocations back to the system, returns the bytes freed
+    size_t trim( AllocatorAffinity );
+    size_t trim();
+
+    // bytes of block and arena memory held for an affinity
+    size_t backing_size( AllocatorAffinity ) const;
+
+    // Preallocates and prefaults the configured blocks and, unless allowed, stops taking memory from
+    // the system: allocations that do not fit throw std::bad_alloc and new arenas are nullptr after
+    // onGrowthFailure, trim() keeps the blocks. Meant to run once at startup and needs a block policy such as ALLOCATOR_POLICY_AER_ALLOC_DEALLOC.
+    // false when the policy does not use blocks, the budget refused a block or pages could not be locked.
+    bool   make_deterministic( const DeterministicConfig& );
+    bool   growth_allowed() const;
+
+    // the Manager budgeting this allocator, nullptr until attached, see Manager::attach()
+    Manager* manager() const noexcept { return _manager.load( std::memory_order_acquire ); }
 protected:
+    friend Manager;
+
+    bool   deallocate_arena( void* );
+    void   free_arena( Arena& ) noexcept;
+    bool   preallocate( AllocatorAffinity, bool lock );
+    void   growth_refused( std::size_t, AllocatorAffinity );
+
     std::vector<std::unique_ptr<MemoryBlocks>>  _memoryBlocks;
+    std::map<void*, std::unique_ptr<Arena>>     _arenas;
+    bool                                        _growthAllowed = true;
+    std::atomic<Manager*>                       _manager       = nullptr;
+private:
+    mutable     Mutex                           _mutex{ "mem::Allocator" };
+};
+
+// per thread placement state, read by allocate() when no explicit hint is given
+inline const void*& placement_hint() noexcept { thread_local const void* hint  = nullptr; return hint; }
+inline Arena*&      current_arena()  noexcept { thread_local Arena*      arena = nullptr; return arena; }
+
+// allocations on this thread are placed near hint while the scope is alive, if the policy uses blocks
+struct PlacementScope
+{
+    explicit PlacementScope( const void* hint ) : _previous( placement_hint() ) { placement_hint() = hint; }
+            ~PlacementScope() { placement_hint() = _previous; }
+
+    PlacementScope( const PlacementScope& )              = delete;
+    PlacementScope& operator = ( const PlacementScope& ) = delete;
+private:
+    const void* _previous;
+};
+
+// allocations of the arena's affinity on this thread come from the arena while the scope is alive
+struct ArenaScope
+{
+    explicit ArenaScope( Arena* arena ) : _previous( current_arena() ) { current_arena() = arena; }
+            ~ArenaScope() { current_arena() = _previous; }
+
+    ArenaScope( const ArenaScope& )              = delete;
+    ArenaScope& operator = ( const ArenaScope& ) = delete;
 private:
-    mutable     std::mutex                      _mutex;
+    Arena* _previous;
 };
 
 static inline void* alloc( size_t size, AllocatorAffinity affinity = ALLOCATOR_AFFINITY_OBJECTS )
 {
-    return Allocator::instance()->allocate( size, affinity );
+    return Allocator::instance().allocate( size, affinity, placement_hint() );
 }
 
 static inline void dealloc( void* ptr, size_t size = 0 )
 {
-    Allocator::instance()->deallocate( ptr, size );
+    // memory outliving the allocator went back with its blocks
+    if( auto allocator = Allocator::existing() ) allocator->deallocate( ptr, size );
 }
 
 } // namespace aer::mem
@@ -1,37 +1,91 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <vector>
 
-#include ""
+#include "../interfaces/singleton.h"
+#include "../Mutex.h"
+#include "Allocator.h"
 
 namespace aer
 {
 namespace mem
 {
 
-class Manager
+enum MemoryPressure : uint8_t
 {
-public:
-    Manager();
-    static std::unique_ptr<Manager>& instance() noexcept;
-    
-    template< typename T >
-    bool ref( const Object*, std::memory_order = std::memory_order_relaxed ) noexcept;
-    template< typename T >
-    bool unref( const Object*, std::memory_order = std::memory_order_seq_cst ) noexcept;
-}
-
-template< typename T >
-static inline bool ref( const T const* ob, std::memory_order order = std::memory_order_relaxed ) noexcept
+    MEMORY_PRESSURE_NONE    = 0,
+    MEMORY_PRESSURE_SOFT,           // usage rose past the soft budget
+    MEMORY_PRESSURE_HARD            // growth would exceed the hard budget and fails unless memory is freed
+};
+
+struct MemoryBudget
 {
-    return Manager::instance()->ref( obj );
-}
+    size_t soft = SIZE_MAX;
+    size_t hard = SIZE_MAX;
+};
 
-template< typename T >
-static inline bool unref( const T const* obj, std::memory_order order = std::memory_order_seq_cst ) noexcept
+// Budgets the memory the attached allocators take from the system, per AllocatorAffinity.
+// An attached allocator reserves block and arena memory here before growing and releases it when it
+// trims, so the counts cover backing memory, not individual allocations. Under ALLOCATOR_POLICY_DEFAULT
+// and STD_MALLOC_FREE allocations go straight to the system and are neither counted nor refused, only
+// arenas are; budgets need a block policy such as ALLOCATOR_POLICY_AER_ALLOC_DEALLOC.
+// Pressure callbacks run on the growing thread without allocator locks held and may free memory or
+// call Allocator::trim(); a hard budget trims every attached allocator before growth is refused.
+// The constructor attaches the process allocator, creating it first so it outlives the Manager.
+// Allocators constructed directly are budgeted once attached and detach themselves when destroyed.
+class Manager : public ISingleton<Manager>
 {
-    return Manager::instance()->unref( obj );
-}
+public:
+    // one account per possible affinity value, so any affinity an allocator grows can be budgeted
+    constexpr static size_t MAX_AFFINITIES = 256;
+
+    using PressureCallback = std::function<void( AllocatorAffinity, MemoryPressure, size_t used )>;
+    using callback_t       = uint32_t;
+
+    Manager();
+   ~Manager();
+
+    void            set_budget( AllocatorAffinity, MemoryBudget ) noexcept;
+    MemoryBudget    budget(     AllocatorAffinity ) const noexcept;
+    size_t          used(       AllocatorAffinity affinity ) const noexcept { return _accounts[affinity].used.load( std::memory_order_relaxed ); }
+    MemoryPressure  pressure(   AllocatorAffinity ) const noexcept;
+
+    callback_t      add_pressure_callback( PressureCallback );
+    bool            remove_pressure_callback( callback_t );
+
+    // memory the allocator already holds is accounted but never refused, false when it is attached elsewhere
+    bool attach( Allocator& );
+    // its backing memory leaves the accounts, called by ~Allocator()
+    void detach( Allocator& ) noexcept;
+
+    // called by allocators before taking bytes from the system, false leaves the usage unchanged
+    bool reserve( AllocatorAffinity, size_t bytes );
+    void release( AllocatorAffinity, size_t bytes ) noexcept;
+
+private:
+    struct Account
+    {
+        std::atomic<size_t>         used     = 0;
+        std::atomic<size_t>         soft     = SIZE_MAX;
+        std::atomic<size_t>         hard     = SIZE_MAX;
+        std::atomic<MemoryPressure> pressure = MEMORY_PRESSURE_NONE;
+    };
+
+    bool try_reserve( Account&, size_t bytes ) noexcept;
+    void raise( AllocatorAffinity, MemoryPressure, size_t used );
+
+    using Callbacks = std::vector<std::pair<callback_t, std::shared_ptr<PressureCallback>>>;
+
+    std::array<Account, MAX_AFFINITIES> _accounts;
+    mutable Mutex                       _mutex{ "mem::Manager" };
+    Callbacks                           _callbacks;
+    callback_t                          _nextCallback = 1;
+    std::vector<Allocator*>             _allocators;
+};
 
 } // namespace aer::mem
 } // namespace aer
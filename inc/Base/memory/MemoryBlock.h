@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 #include "MemorySlots.h"
 #include "AllocatorPolicy.h"
 
@@ -11,6 +13,7 @@ struct MemoryBlock
     friend struct MemoryBlocks;
 
     constexpr static size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+    constexpr static size_t ALIGNMENT          = alignof( std::max_align_t );
 
     const AllocatorPolicy policy;
 
@@ -18,11 +21,18 @@ struct MemoryBlock
     ~MemoryBlock();
 
 protected:
-    void* allocate( size_t );
+    // hint, when inside this block, asks for memory as close to it as possible
+    void* allocate( size_t, const void* hint = nullptr );
     bool  deallocate( void*, size_t );
+    bool  contains( const void* ptr ) const noexcept { return ptr >= _memory && ptr < _memory + _slots.totalMemorySize(); }
+
+    // touches every page so later allocations do not fault, lock also keeps them resident
+    // false when the pages could not be locked, e.g. over RLIMIT_MEMLOCK
+    bool  prefault( bool lock );
 
     MemorySlots           _slots;
     uint8_t*              _memory = nullptr;
+    bool                  _locked = false;
 };
 
 } // namespace aer::mem
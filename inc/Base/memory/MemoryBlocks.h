@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "MemoryBlock.h"
 
 namespace aer::mem
@@ -17,9 +19,19 @@ struct MemoryBlocks
     Allocator const*    parent;
     const size_t        blockSize;
 
+    // bytes a new block needs to hold an allocation of size
+    size_t growth( size_t size ) const noexcept { return std::max( size, blockSize ); }
+    size_t totalMemorySize() const noexcept;
+
 protected:
-    void* allocate( size_t );
-    bool deallocate( void*, size_t );
+    // tries the block holding hint first, then the latest block and then all others, never grows
+    void*  allocate( size_t, const void* hint = nullptr );
+    void*  grow( size_t );
+    // adds an empty, prefaulted block of blockSize, false when its pages could not be locked
+    bool   preallocate( bool lock );
+    bool   deallocate( void*, size_t );
+    // frees blocks without reservations, returns the bytes given back
+    size_t trim();
 
     std::map<void*, std::shared_ptr<MemoryBlock>> _blocks;
     std::shared_ptr<MemoryBlock>                  _latestBlock;
@@ -27,6 +27,8 @@ struct MemorySlots
 {
     // default alignment is 4 bytes or 64 bits
     constexpr static size_t DEFAULT_ALIGNMENT = 4;
+    // free slots examined on either side of a hint before reserve_near() gives up on locality
+    constexpr static size_t NEAR_SEARCH_LIMIT = 8;
 
     // whether to report or check memory actions, can flood the log with messages however
     mutable MemoryTracking memoryTracking;
@@ -35,6 +37,8 @@ struct MemorySlots
 
     // Returns the offset of the reserved memory, or std::nullopt if no memory is available.
     std::optional<offset_t> reserve( size_t size, size_t alignment = DEFAULT_ALIGNMENT );
+    // Like reserve(), but prefers the free memory closest to hint, e.g. right behind a sibling.
+    std::optional<offset_t> reserve_near( size_t size, offset_t hint, size_t alignment = DEFAULT_ALIGNMENT );
     // Releases the memory at the given offset, returning true if the memory was reserved.
     bool release( offset_t offset, size_t size );
 
@@ -53,8 +57,9 @@ struct MemorySlots
         return std::accumulate( _reservedMemory.begin(), _reservedMemory.end(), 0, []( auto sum, auto& slot ) { return sum + slot.second; } );
     }
 protected:
-    void insert( offset_t, size_t );
-    void remove( offset_t, size_t );
+    void     insert( offset_t, size_t );
+    void     remove( offset_t, size_t );
+    offset_t carve( offset_t slotStart, size_t slotSize, offset_t alignedStart, size_t size );
 private:
     std::multimap<size_t, offset_t> _availableMemory;
     std::map<offset_t, size_t>      _reservedMemory;
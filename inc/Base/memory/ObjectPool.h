@@ -0,0 +1,137 @@
+#pragma once
+
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <concepts>
+
+#include "../Mutex.h"
+
+namespace aer::mem
+{
+
+// opt in by declaring `static constexpr std::size_t pool_capacity = N;` on an inherit<> derived type
+template< typename T >
+concept pooled = requires { { T::pool_capacity } -> std::convertible_to<std::size_t>; };
+
+struct ObjectPoolStats
+{
+    std::size_t capacity = 0; // freelist limit per thread
+    std::size_t cached   = 0; // blocks currently held by freelists
+    std::size_t hits     = 0; // allocations served from a freelist
+    std::size_t misses   = 0; // allocations forwarded to the upstream allocator
+    std::size_t recycled = 0; // deallocations kept on a freelist
+    std::size_t released = 0; // deallocations returned upstream because the freelist was full
+};
+
+// Thread local freelists of blocks sized for T.
+// Blocks are obtained from and returned to Upstream's class allocation functions, a refused upstream
+// allocation throws std::bad_alloc out of acquire() and leaves the freelist untouched.
+template< typename T, typename Upstream >
+class ObjectPool
+{
+public:
+    static constexpr std::size_t block_size = sizeof( T );
+
+    static void* acquire()
+    {
+        auto& local = _local;
+        if( auto block = local.head )
+        {
+            local.head = block->next;
+            bump( local.cached, -1 );
+            bump( local.hits );
+            return block;
+        }
+        bump( local.misses );
+        return upstream_allocate();
+    }
+
+    static void release( void* ptr )
+    {
+        auto& local = _local;
+        if( local.cached.load( std::memory_order_relaxed ) < _capacity.load( std::memory_order_relaxed ) )
+        {
+            local.head = ::new( ptr ) Block{ local.head };
+            bump( local.cached );
+            bump( local.recycled );
+            return;
+        }
+        bump( local.released );
+        upstream_deallocate( ptr );
+    }
+
+    static std::size_t capacity() noexcept { return _capacity.load( std::memory_order_relaxed ); }
+
+    // takes effect as blocks are released, freelists above the new limit drain naturally
+    static void set_capacity( std::size_t capacity ) noexcept { _capacity.store( capacity, std::memory_order_relaxed ); }
+
+    static ObjectPoolStats stats()
+    {
+        std::scoped_lock lock( _mutex );
+        auto stats     = _retired;
+        stats.capacity = capacity();
+        for( auto local : _threads )
+        {
+            stats.cached   += local->cached.load( std::memory_order_relaxed );
+            stats.hits     += local->hits.load( std::memory_order_relaxed );
+            stats.misses   += local->misses.load( std::memory_order_relaxed );
+            stats.recycled += local->recycled.load( std::memory_order_relaxed );
+            stats.released += local->released.load( std::memory_order_relaxed );
+        }
+        return stats;
+    }
+
+    static void* upstream_allocate() { return Upstream::operator new( block_size ); }
+
+    static void upstream_deallocate( void* ptr )
+    {
+        if constexpr( requires( void* p, std::size_t n ){ Upstream::operator delete( p, n ); } ) Upstream::operator delete( ptr, block_size );
+        else                                                                                   Upstream::operator delete( ptr );
+    }
+
+private:
+    struct Block { Block* next; };
+    static_assert( block_size >= sizeof( Block ) );
+
+    // counters are only written by the owning thread, so plain loads and stores suffice
+    using counter_t = std::atomic<std::size_t>;
+    static void bump( counter_t& counter, std::ptrdiff_t delta = 1 ) noexcept
+    {
+        counter.store( counter.load( std::memory_order_relaxed ) + delta, std::memory_order_relaxed );
+    }
+
+    struct Local
+    {
+        Block*    head = nullptr;
+        counter_t cached{ 0 }, hits{ 0 }, misses{ 0 }, recycled{ 0 }, released{ 0 };
+
+        Local()
+        {
+            std::scoped_lock lock( _mutex );
+            _threads.push_back( this );
+        }
+
+        ~Local()
+        {
+            while( head ) { auto next = head->next; upstream_deallocate( head ); head = next; }
+
+            std::scoped_lock lock( _mutex );
+            _retired.hits     += hits.load( std::memory_order_relaxed );
+            _retired.misses   += misses.load( std::memory_order_relaxed );
+            _retired.recycled += recycled.load( std::memory_order_relaxed );
+            _retired.released += released.load( std::memory_order_relaxed ) + cached.load( std::memory_order_relaxed );
+            std::erase( _threads, this );
+        }
+    };
+
+    static inline thread_local Local        _local;
+    static inline std::atomic<std::size_t>  _capacity = T::pool_capacity;
+    static inline Mutex                     _mutex{ "mem::ObjectPool" };
+    static inline std::vector<Local*>       _threads;
+    static inline ObjectPoolStats           _retired;
+};
+
+} // namespace aer::mem
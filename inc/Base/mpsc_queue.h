@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace aer
+{
+
+// Bounded lock-free multi-producer / single-consumer ring.
+// Every cell carries a sequence number, producers claim a position with one CAS and publish
+// the cell by advancing its sequence, so neither side ever takes a lock or allocates.
+template< typename T >
+class mpsc_queue
+{
+public:
+    explicit mpsc_queue( size_t capacity )
+        : _capacity( std::bit_ceil( std::max<size_t>( capacity, 2 ) ) ), _mask( _capacity - 1 ), _cells( new Cell[_capacity] )
+    {
+        for( size_t i = 0; i < _capacity; ++i ) _cells[i].sequence.store( i, std::memory_order_relaxed );
+    }
+
+    ~mpsc_queue() { pop( size() ); }
+
+    mpsc_queue( const mpsc_queue& )              = delete;
+    mpsc_queue& operator = ( const mpsc_queue& ) = delete;
+
+    size_t capacity() const noexcept { return _capacity; }
+
+    // approximate when called concurrently with producers
+    size_t size() const noexcept
+    {
+        auto enqueued = _enqueue.load( std::memory_order_acquire );
+        auto dequeued = _dequeue.load( std::memory_order_relaxed );
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    bool empty() const noexcept { return peek( 0 ) == nullptr; }
+
+    // producers, returns false without touching args when the queue is full
+    template< typename... Args >
+    bool try_emplace( Args&&... args )
+    {
+        auto  pos  = _enqueue.load( std::memory_order_relaxed );
+        Cell* cell = nullptr;
+        for( ;; )
+        {
+            cell = &_cells[pos & _mask];
+            auto sequence = cell->sequence.load( std::memory_order_acquire );
+            auto diff     = static_cast<intptr_t>( sequence ) - static_cast<intptr_t>( pos );
+
+            if( diff == 0 )
+            {
+                if( _enqueue.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) break;
+            }
+            else if( diff < 0 ) return false;
+            else pos = _enqueue.load( std::memory_order_relaxed );
+        }
+
+        ::new( cell->storage ) T( std::forward<Args>( args )... );
+        cell->sequence.store( pos + 1, std::memory_order_release );
+        return true;
+    }
+
+    // consumer, returns the element offset positions behind the head once it has been published
+    // other threads may call it as a hint, e.g. through empty(), but must not use the element
+    T* peek( size_t offset ) const noexcept
+    {
+        auto  pos  = _dequeue.load( std::memory_order_relaxed ) + offset;
+        auto& cell = _cells[pos & _mask];
+        if( offset >= _capacity || cell.sequence.load( std::memory_order_acquire ) != pos + 1 ) return nullptr;
+        return std::launder( reinterpret_cast<T*>( cell.storage ) );
+    }
+
+    // consumer, destroys count elements from the head and hands their cells back to producers. It neither
+    // waits for nor skips cells a producer has claimed but not yet published, so all count must have been
+    // seen through peek(); size() includes such cells and is only safe to pop once producers have stopped
+    void pop( size_t count = 1 ) noexcept
+    {
+        auto pos = _dequeue.load( std::memory_order_relaxed );
+        for( ; count > 0; --count, ++pos )
+        {
+            auto& cell = _cells[pos & _mask];
+            std::launder( reinterpret_cast<T*>( cell.storage ) )->~T();
+            cell.sequence.store( pos + _capacity, std::memory_order_release );
+            _dequeue.store( pos + 1, std::memory_order_relaxed );
+        }
+    }
+
+    // consumer, invokes fn( T& ) on up to max elements in order and pops them, returns the number consumed
+    template< typename F >
+    size_t consume( F&& fn, size_t max = SIZE_MAX )
+    {
+        size_t count = 0;
+        for( ; count < max; ++count )
+        {
+            auto element = peek( 0 );
+            if( !element ) break;
+            fn( *element );
+            pop();
+        }
+        return count;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t>             sequence;
+        alignas( T ) std::byte          storage[sizeof( T )];
+    };
+
+    const size_t                        _capacity;
+    const size_t                        _mask;
+    std::unique_ptr<Cell[]>             _cells;
+
+    // producers and the consumer write to separate cache lines
+    alignas( 64 ) std::atomic<size_t>   _enqueue = 0;
+    alignas( 64 ) std::atomic<size_t>   _dequeue = 0; // only written by the consumer
+};
+
+} // namespace aer
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "node.h"
+
+namespace aer {
+
+// Immutable sequence of children whose versions share structure.
+// Children are stored in chunks of CHUNK_SIZE; an edit copies the chunk table and the one chunk it
+// touches and shares all others, so a reader can keep a version for as long as it likes while
+// writers move on, without holding a lock while it reads and without copying the whole list.
+class ChildList
+{
+public:
+    constexpr static size_t CHUNK_SIZE = 64;
+
+    using value_type = ref_ptr<Node>;
+    using Chunk      = std::vector<value_type>;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = ChildList::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const value_type*;
+        using reference         = const value_type&;
+
+        const_iterator() noexcept = default;
+        const_iterator( const ChildList* list, size_t index ) noexcept : _list( list ), _index( index ) {}
+
+        reference operator *  () const noexcept                    { return ( *_list )[_index]; }
+        pointer   operator -> () const noexcept                    { return &( *_list )[_index]; }
+        reference operator [] ( difference_type n ) const noexcept { return ( *_list )[_index + n]; }
+
+        const_iterator& operator ++ () noexcept    { ++_index; return *this; }
+        const_iterator& operator -- () noexcept    { --_index; return *this; }
+        const_iterator  operator ++ ( int ) noexcept { auto copy = *this; ++_index; return copy; }
+        const_iterator  operator -- ( int ) noexcept { auto copy = *this; --_index; return copy; }
+
+        const_iterator& operator += ( difference_type n ) noexcept { _index += n; return *this; }
+        const_iterator& operator -= ( difference_type n ) noexcept { _index -= n; return *this; }
+
+        friend const_iterator  operator + ( const_iterator itr, difference_type n ) noexcept { return itr += n; }
+        friend const_iterator  operator + ( difference_type n, const_iterator itr ) noexcept { return itr += n; }
+        friend const_iterator  operator - ( const_iterator itr, difference_type n ) noexcept { return itr -= n; }
+        friend difference_type operator - ( const const_iterator& lhs, const const_iterator& rhs ) noexcept
+        {
+            return static_cast<difference_type>( lhs._index ) - static_cast<difference_type>( rhs._index );
+        }
+
+        friend bool                 operator ==  ( const const_iterator& lhs, const const_iterator& rhs ) noexcept { return lhs._index == rhs._index; }
+        friend std::strong_ordering operator <=> ( const const_iterator& lhs, const const_iterator& rhs ) noexcept { return lhs._index <=> rhs._index; }
+
+    private:
+        const ChildList* _list  = nullptr;
+        size_t           _index = 0;
+    };
+
+    using iterator               = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    ChildList() noexcept = default;
+
+    // count null children
+    explicit ChildList( size_t count ) : _size( count )
+    {
+        for( size_t offset = 0; offset < count; offset += CHUNK_SIZE )
+        {
+            _chunks.push_back( std::make_shared<const Chunk>( std::min( CHUNK_SIZE, count - offset ) ) );
+        }
+    }
+
+    explicit ChildList( std::vector<value_type> children ) : _size( children.size() )
+    {
+        for( size_t offset = 0; offset < children.size(); offset += CHUNK_SIZE )
+        {
+            auto last = children.begin() + std::min( offset + CHUNK_SIZE, children.size() );
+            _chunks.push_back( std::make_shared<const Chunk>( std::make_move_iterator( children.begin() + offset ), std::make_move_iterator( last ) ) );
+        }
+    }
+
+    size_t size()  const noexcept { return _size; }
+    bool   empty() const noexcept { return _size == 0; }
+
+    const value_type& operator [] ( size_t index ) const noexcept { return ( *_chunks[index / CHUNK_SIZE] )[index % CHUNK_SIZE]; }
+    const value_type& back() const noexcept { return ( *this )[_size - 1]; }
+
+    const_iterator         begin()  const noexcept { return { this, 0 }; }
+    const_iterator         end()    const noexcept { return { this, _size }; }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator( end() ); }
+    const_reverse_iterator rend()   const noexcept { return const_reverse_iterator( begin() ); }
+
+    // the edits return a new version and leave this one untouched
+    [[nodiscard]] ChildList push_back( value_type child ) const
+    {
+        const bool full  = _size % CHUNK_SIZE == 0;
+        auto       chunk = full ? std::make_shared<Chunk>() : std::make_shared<Chunk>( *_chunks.back() );
+        chunk->reserve( CHUNK_SIZE );
+        chunk->push_back( std::move( child ) );
+
+        auto list = *this;
+        if( full ) list._chunks.push_back( std::move( chunk ) );
+        else       list._chunks.back() = std::move( chunk );
+        ++list._size;
+        return list;
+    }
+
+    [[nodiscard]] ChildList set( size_t index, value_type child ) const
+    {
+        auto  list  = *this;
+        auto  chunk = std::make_shared<Chunk>( *_chunks[index / CHUNK_SIZE] );
+        ( *chunk )[index % CHUNK_SIZE] = std::move( child );
+        list._chunks[index / CHUNK_SIZE] = std::move( chunk );
+        return list;
+    }
+
+private:
+    std::vector<std::shared_ptr<const Chunk>> _chunks;
+    size_t                                    _size = 0;
+};
+
+} // namespace aer
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <span>
+#include <unordered_map>
+
+#include "Node.h"
+#include "Group.h"
+
+namespace aer {
+
+// Compiled, read-only image of a Node/Group graph.
+// Nodes are laid out depth first in pre-order with one array per field, so a traversal streams through
+// memory instead of chasing ref_ptrs. The subtree of i spans [i, skip( i )): its first child is i + 1
+// and every next sibling is found at skip() of the previous one. A node is expanded where it is first
+// reached; a shared node reached again, including an ancestor closing a cycle, is emitted as a leaf
+// reference to that first occurrence. Null children are left out. The image holds its nodes but does
+// not follow later edits of the graph.
+struct FlatGraph : public inherit<FlatGraph, Object>
+{
+    using index_t = uint32_t;
+
+    static constexpr index_t npos = ~index_t( 0 );
+
+    static ref_ptr<FlatGraph> compile( const ref_ptr<Node>& root );
+
+    index_t size()  const noexcept { return static_cast<index_t>( _nodes.size() ); }
+    bool    empty() const noexcept { return _nodes.empty(); }
+
+    // structure of arrays, all indexed by pre-order position
+    std::span<const type_id_t> types()        const noexcept { return _types; }
+    std::span<const index_t>   parents()      const noexcept { return _parents; }
+    std::span<const index_t>   skips()        const noexcept { return _skips; }
+    std::span<const uint32_t>  depths()       const noexcept { return _depths; }
+    std::span<const uint32_t>  child_counts() const noexcept { return _childCounts; }
+    std::span<const index_t>   originals()    const noexcept { return _originals; }
+
+    index_t  parent( index_t i )       const noexcept { return _parents[i]; }
+    index_t  skip( index_t i )         const noexcept { return _skips[i]; }
+    uint32_t depth( index_t i )        const noexcept { return _depths[i]; }
+    uint32_t child_count( index_t i )  const noexcept { return _childCounts[i]; }
+    index_t  subtree_size( index_t i ) const noexcept { return _skips[i] - i; }
+
+    // first occurrence of the node at i, i itself unless i is a reference
+    index_t  original( index_t i )     const noexcept { return _originals[i]; }
+    bool     is_reference( index_t i ) const noexcept { return _originals[i] != i; }
+
+    // maps results back to the original graph, find() returns the first occurrence of node
+    Node*   node( index_t i ) const noexcept { return _nodes[i].get(); }
+    index_t find( const Node* node ) const;
+
+    // invokes fn( index_t ) for every child of i in order
+    template< typename F > requires std::invocable<F, index_t>
+    void for_each_child( index_t i, F&& fn ) const
+    {
+        for( index_t child = i + 1; child < _skips[i]; child = _skips[child] ) fn( child );
+    }
+
+    // linear pre-order walk below root, fn( index_t ) returning false skips the subtree of that node
+    template< typename F > requires std::invocable<F, index_t>
+    void traverse( F&& fn, index_t root = 0 ) const
+    {
+        if( root >= size() ) return;
+        for( index_t i = root, end = _skips[root]; i < end; )
+        {
+            if constexpr( std::same_as<std::invoke_result_t<F, index_t>, bool> ) i = fn( i ) ? i + 1 : _skips[i];
+            else { fn( i ); ++i; }
+        }
+    }
+
+    // hands every node to the visitor once, in the order Group::traverse first reaches it
+    template< typename V >
+    void accept_all( V& visitor ) const
+    {
+        for( index_t i = 0; i < size(); ++i ) if( !is_reference( i ) ) _nodes[i]->accept( visitor );
+    }
+
+protected:
+    friend inherit;
+    FlatGraph() = default;
+
+    std::vector<type_id_t>      _types;
+    std::vector<index_t>        _parents;
+    std::vector<index_t>        _skips;
+    std::vector<uint32_t>       _depths;
+    std::vector<uint32_t>       _childCounts;
+    std::vector<index_t>        _originals;
+    std::vector<ref_ptr<Node>>  _nodes;
+
+    std::unordered_map<const Node*, index_t> _indices;
+};
+
+} // namespace aer
@@ -1,24 +1,97 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 #include "node.h"
+#include "ChildList.h"
+#include "../Profiler.h"
 
 namespace aer {
 
-struct Group : public Node
+struct Group : public inherit<Group, Node>
 {
-    explicit Group( std::size_t num_children ) : children( num_children ) {};
-            ~Group() = default;
+    using Children = ChildList;
+
+    explicit Group( std::size_t num_children ) : _children( std::make_shared<const Children>( num_children ) ) {};
+            ~Group() { auto children = this->children(); for( auto& child : *children ) unlink( child.get() ); }
+
+    // the current version, readers on any thread keep it unchanged for as long as they hold it
+    std::shared_ptr<const Children> children() const noexcept { return _children.load( std::memory_order_acquire ); }
 
-    using Children = std::vector<ref_ptr<Node>>;
-    Children children;
+    // edits publish a new version of the children, edits of one group must not run concurrently; groups
+    // sharing a child may be edited on different threads, and the child touched on yet another
+    void add( ref_ptr<Node> child )
+    {
+        const auto version = next_version();
+        link( child.get(), version );
+        publish( children()->push_back( std::move( child ) ), version );
+    };
 
-    void add( ref_ptr<Node> child ){ children.push_back( child ); };
+    // creates the child right behind its previous sibling, or next to this group for the first one, when
+    // the allocator policy uses blocks, see mem::Allocator::allocate()
+    template< std::derived_from<Node> T, typename... Args >
+    ref_ptr<T> emplace( Args&&... args )
+    {
+        auto children = this->children();
+        mem::PlacementScope placement( !children->empty() && children->back() ? static_cast<const void*>( children->back().get() ) : this );
+        auto child = T::create( std::forward<Args>( args )... );
+        add( ref_ptr<Node>( child.get() ) );
+        return child;
+    }
+
+    void set( std::size_t index, ref_ptr<Node> child )
+    {
+        const auto version  = next_version();
+        auto       children = this->children();
+        unlink( ( *children )[index].get() );
+        link( child.get(), version );
+        publish( children->set( index, std::move( child ) ), version );
+    }
+
+    // replaces all children in one version
+    void assign( std::vector<ref_ptr<Node>> children )
+    {
+        const auto version  = next_version();
+        auto       previous = this->children();
+        for( auto& child : *previous ) unlink( child.get() );
+        for( auto& child : children ) link( child.get(), version );
+        publish( Children( std::move( children ) ), version );
+    }
 
     template< typename Self, typename Visitor > constexpr
     void traverse( this Self&& self, Visitor& visitor )
     {
-        for( auto& child : self.children ){ child->accept( visitor ); }
+        AER_PROFILE_SCOPE( "Group::traverse" );
+        auto children = self.children();
+        for( auto& child : *children ){ child->accept( visitor ); }
+    }
+
+private:
+    // the linked children carry version before the new list is published, so a traversal that finds
+    // them there also sees them as new
+    void publish( Children children, uint64_t version )
+    {
+        _children.store( std::make_shared<const Children>( std::move( children ) ), std::memory_order_release );
+        modified( version );
     }
+
+    void link( Node* child, uint64_t version )
+    {
+        if( !child ) return;
+        child->add_parent( this );
+        child->_linkedVersion.store( version, std::memory_order_release );
+    }
+
+    void unlink( Node* child )
+    {
+        if( child ) child->remove_parent( this );
+    }
+
+    // not lock free in libstdc++ and MSVC, loads and stores take a short internal lock around the
+    // pointer and reference count, iterating a loaded version takes none
+    std::atomic<std::shared_ptr<const Children>> _children;
 };
 
-} // namespace aer
\ No newline at end of file
+} // namespace aer
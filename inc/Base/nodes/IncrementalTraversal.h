@@ -0,0 +1,86 @@
+#pragma once
+
+#include <span>
+#include <unordered_map>
+
+#include "Group.h"
+
+namespace aer {
+
+// Pre-order traversal that only enters subtrees changed after since and only hands nodes modified after
+// since to node.accept( visitor ). A subtree linked into a group after since is visited in full, however
+// old its nodes are. Returns the version to pass on the next call; changes made while the traversal runs
+// are picked up by that call.
+template< typename V >
+uint64_t traverse_changed( Node& root, V& visitor, uint64_t since )
+{
+    const auto version = Node::current_version();
+
+    // the flag marks nodes below a newly linked child
+    std::vector<std::pair<Node*, bool>> stack{ { &root, false } };
+    while( !stack.empty() )
+    {
+        auto [node, linked] = stack.back();
+        stack.pop_back();
+        linked = linked || node->linked_version() > since;
+        if( !linked && !node->changed_since( since ) ) continue;
+
+        if( linked || node->version() > since ) node->accept( visitor );
+        if( auto group = aer::cast<Group>( node ) )
+        {
+            auto children = group->children();
+            for( auto child = children->rbegin(); child != children->rend(); ++child )
+            {
+                if( *child ) stack.emplace_back( child->get(), linked );
+            }
+        }
+    }
+    return version;
+}
+
+// Memoises one result per subtree.
+// evaluate() calls fn( Node&, std::span<const R> children ) bottom up, but only for subtrees whose
+// version differs from the one their cached result was computed at, so a pass over a mostly unchanged
+// graph costs roughly the size of the change. Null children are skipped.
+template< typename R >
+class SubtreeCache
+{
+public:
+    template< typename F > requires std::invocable<F, Node&, std::span<const R>>
+    const R& evaluate( Node& node, F&& fn )
+    {
+        const auto version = node.subtree_version();
+        if( auto itr = _entries.find( &node ); itr != _entries.end() && itr->second.version == version ) return itr->second.result;
+
+        std::vector<R> children;
+        if( auto group = aer::cast<Group>( &node ) )
+        {
+            auto list = group->children();
+            children.reserve( list->size() );
+            for( auto& child : *list ) if( child ) children.push_back( evaluate( *child, fn ) );
+        }
+
+        // versions are never reused, so an entry left behind by a destroyed node can not match its successor
+        auto& entry = _entries[&node];
+        entry.version = version;
+        entry.result  = fn( node, std::span<const R>( children ) );
+        return entry.result;
+    }
+
+    size_t size() const noexcept { return _entries.size(); }
+    void   clear() noexcept      { _entries.clear(); }
+
+    // drops the cached result of node, e.g. when fn depends on state outside the graph
+    void invalidate( const Node& node ) { _entries.erase( &node ); }
+
+private:
+    struct Entry
+    {
+        uint64_t version = 0;
+        R        result{};
+    };
+
+    std::unordered_map<const Node*, Entry> _entries;
+};
+
+} // namespace aer
@@ -1,20 +1,93 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "../object.h"
+#include "../inherit.h"
 #include "../memory/Allocator.h"
 
 namespace aer {
 
-struct Node : public Object
+struct Node : public inherit<Node, Object>
 {
     Node()  = default;
     ~Node() = default;
     
-    static void* operator new( size_t count ) { return mem::alloc( count, mem::ALLOCATOR_AFFINITY_NODES ); }
-    static void  operator delete( void* ptr ) { mem::dealloc( ptr, mem::ALLOCATOR_AFFINITY_NODES ); }
+    // placed near mem::placement_hint() or inside the current mem::ArenaScope, see Group::emplace()
+    static void* operator new( size_t count )               { return mem::alloc( count, mem::ALLOCATOR_AFFINITY_NODES ); }
+    static void  operator delete( void* ptr, size_t count ) { mem::dealloc( ptr, count ); }
     
     template< typename Self, typename Visitor > constexpr
     void traverse( this Self&& self, Visitor& visitor ) {};
+
+    // versions come from one global clock, the subtree version is the newest version at or below this node
+    uint64_t version()                    const noexcept { return _version.load( std::memory_order_acquire ); }
+    uint64_t subtree_version()            const noexcept { return _subtreeVersion.load( std::memory_order_acquire ); }
+    bool     changed_since( uint64_t v )  const noexcept { return subtree_version() > v; }
+    // version of the edit that last added the node to a group, its whole subtree is new to that group's ancestors
+    uint64_t linked_version()             const noexcept { return _linkedVersion.load( std::memory_order_acquire ); }
+
+    // marks the node as modified and every ancestor as dirty, call after mutating it
+    void touch() noexcept { modified( next_version() ); }
+
+    static uint64_t current_version() noexcept { return clock().load( std::memory_order_acquire ); }
+
+protected:
+    friend struct Group;
+
+    using Parents = std::vector<Node*>;
+
+    static std::atomic<uint64_t>& clock() noexcept { static std::atomic<uint64_t> clock = 0; return clock; }
+    static uint64_t next_version() noexcept { return clock().fetch_add( 1, std::memory_order_acq_rel ) + 1; }
+
+    void modified( uint64_t version ) noexcept
+    {
+        _version.store( version, std::memory_order_release );
+        propagate( version );
+    }
+
+    void propagate( uint64_t version ) noexcept
+    {
+        // an ancestor that already carries a newer version has passed it on to its own ancestors
+        auto current = _subtreeVersion.load( std::memory_order_relaxed );
+        while( current < version && !_subtreeVersion.compare_exchange_weak( current, version, std::memory_order_acq_rel, std::memory_order_relaxed ) );
+        if( current >= version ) return;
+
+        if( auto parents = _parents.load( std::memory_order_acquire ) ) for( auto parent : *parents ) parent->propagate( version );
+    }
+
+    // links are replaced rather than modified, so groups sharing this node may link and unlink it while
+    // touch() propagates on another thread
+    void add_parent( Node* parent )    { update_parents( [&]( Parents& parents ){ parents.push_back( parent ); } ); }
+    void remove_parent( Node* parent )
+    {
+        update_parents( [&]( Parents& parents )
+        {
+            auto itr = std::find( parents.begin(), parents.end(), parent );
+            if( itr != parents.end() ) parents.erase( itr );
+        } );
+    }
+
+    template< typename F >
+    void update_parents( F&& edit )
+    {
+        auto current = _parents.load( std::memory_order_acquire );
+        for( ;; )
+        {
+            auto next = current ? std::make_shared<Parents>( *current ) : std::make_shared<Parents>();
+            edit( *next );
+            if( _parents.compare_exchange_weak( current, std::move( next ), std::memory_order_acq_rel, std::memory_order_acquire ) ) return;
+        }
+    }
+
+    // every Group holding this node, once per reference; maintained by Group
+    std::atomic<std::shared_ptr<const Parents>> _parents;
+    std::atomic<uint64_t>                       _version        = next_version();
+    std::atomic<uint64_t>                       _subtreeVersion = _version.load( std::memory_order_relaxed );
+    std::atomic<uint64_t>                       _linkedVersion  = 0;
 };
 
-} // namespace aer
\ No newline at end of file
+} // namespace aer
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <memory>
+
+#include "Group.h"
+#include "../JobSystem.h"
+
+namespace aer {
+
+// Visitors that keep per-thread state provide clone() and merge(); every thread visits with its own
+// clone, which is merged back into the original once the traversal has finished.
+// Any other visitor is shared between threads and must tolerate concurrent visit() calls.
+template< typename V >
+concept mergeable_visitor = requires( V& visitor, const V& source )
+{
+    { source.clone() } -> std::convertible_to<ref_ptr<V>>;
+    visitor.merge( visitor );
+};
+
+struct TraversalOptions
+{
+    // child ranges up to this size are visited serially by one task
+    size_t grain = 256;
+};
+
+// Pre-order traversal of the graph below root that splits large child ranges into jobs.
+// Every node is passed to node.accept( visitor ) exactly once per path; visitors must not recurse themselves.
+template< typename V >
+void traverse_parallel( Node& root, V& visitor, TraversalOptions options = {}, utils::JobSystem& jobs = utils::JobSystem::instance() )
+{
+    std::vector<ref_ptr<V>> locals;
+    if constexpr( mergeable_visitor<V> ) locals.resize( jobs.size() + 1 );
+
+    auto local = [&]() -> V&
+    {
+        if constexpr( mergeable_visitor<V> )
+        {
+            auto& slot = locals[jobs.worker_index()];
+            if( !slot ) slot = visitor.clone();
+            return *slot;
+        }
+        else return visitor;
+    };
+
+    using Children = std::shared_ptr<const Group::Children>;
+
+    utils::JobCounter counter;
+    std::function<void( const Children&, size_t, size_t )> visit_range;
+
+    // every range holds the version of the children it was split from, so edits do not disturb it
+    auto visit_node = [&]( Node& node )
+    {
+        node.accept( local() );
+        if( auto group = aer::cast<Group>( &node ) )
+        {
+            auto children = group->children();
+            visit_range( children, 0, children->size() );
+        }
+    };
+
+    visit_range = [&]( const Children& children, size_t begin, size_t end )
+    {
+        // split off the upper half until the range is small enough to walk here
+        while( end - begin > options.grain )
+        {
+            auto middle = begin + ( end - begin ) / 2;
+            jobs.run( counter, [&visit_range, children, middle, end]{ visit_range( children, middle, end ); } );
+            end = middle;
+        }
+        for( auto i = begin; i < end; ++i ) if( auto& child = ( *children )[i] ) visit_node( *child );
+    };
+
+    visit_node( root );
+    jobs.wait( counter );
+
+    if constexpr( mergeable_visitor<V> )
+    {
+        for( auto& slot : locals ) if( slot ) visitor.merge( *slot );
+    }
+}
+
+} // namespace aer
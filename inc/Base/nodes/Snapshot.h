@@ -0,0 +1,78 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <unordered_map>
+
+#include "Node.h"
+#include "Group.h"
+
+namespace aer {
+
+// Relocatable binary image of a Node/Group graph.
+// All links are indices into the node and children tables, so a mapped file is usable in place
+// without any pointer fixup. Shared nodes are stored once and null children are kept as npos.
+struct SnapshotHeader
+{
+    static constexpr uint32_t MAGIC   = 0x53524541; // "AERS"
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic          = MAGIC;
+    uint32_t version        = VERSION;
+    uint32_t root           = 0;
+    uint32_t nodeCount      = 0;
+    uint64_t nodesOffset    = 0;
+    uint64_t childrenOffset = 0;
+    uint64_t childrenCount  = 0;
+};
+
+struct SnapshotNode
+{
+    type_id_t type;
+    uint32_t  firstChild;
+    uint32_t  childCount;
+};
+
+struct Snapshot : public inherit<Snapshot, Object>
+{
+    using index_t = uint32_t;
+    using Factory = std::function<ref_ptr<Node>()>;
+
+    static constexpr index_t npos = ~index_t( 0 );
+
+    static bool           write( const ref_ptr<Node>& root, const std::filesystem::path& path );
+    static ref_ptr<Snapshot> map( const std::filesystem::path& path );
+
+    // factories used by materialize(), Node and Group are registered by default
+    template< std::derived_from<Node> T >
+    static void register_type( Factory factory ) { factories()[aer::type_id<T>()] = std::move( factory ); }
+
+    // zero-copy views into the mapped image
+    const SnapshotHeader&         header()                const noexcept { return *reinterpret_cast<const SnapshotHeader*>( _data ); }
+    index_t                       root()                  const noexcept { return header().root; }
+    std::span<const SnapshotNode> nodes()                 const noexcept { return { reinterpret_cast<const SnapshotNode*>( _data + header().nodesOffset ), header().nodeCount }; }
+    std::span<const index_t>      children( index_t node ) const noexcept
+    {
+        auto& record = nodes()[node];
+        return { reinterpret_cast<const index_t*>( _data + header().childrenOffset ) + record.firstChild, record.childCount };
+    }
+
+    // builds the nodes below index that no earlier call has built, so a subtree can be taken on its own
+    // and the rest later; shared nodes are materialised once, a node whose record is corrupt is left null
+    ref_ptr<Node> materialize( index_t index );
+    ref_ptr<Node> materialize() { return materialize( root() ); }
+
+    ~Snapshot();
+protected:
+    friend inherit;
+    Snapshot( const uint8_t* data, size_t size ) : _data( data ), _size( size ) {}
+
+    static std::unordered_map<type_id_t, Factory>& factories();
+
+    const uint8_t*             _data;
+    size_t                     _size;
+    std::vector<ref_ptr<Node>> _materialized;
+};
+
+} // namespace aer
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <concepts>
+#include <array>
+#include <span>
 
 #include "memory/Allocator.h"
 #include "memory/ref_ptr.h"
 
 #include "type_name.h"
+#include "type_id.h"
 
 namespace aer
 {
@@ -13,6 +16,10 @@ namespace aer
 class Object
 {
 public:
+    // ancestor table indexed by depth, the root Object is first and the type itself is last
+    static constexpr std::size_t                            type_depth = 0;
+    static constexpr std::array<type_id_t, type_depth + 1>  type_ancestors{ aer::type_id<Object>() };
+
     static void* operator new( size_t size )  { return mem::alloc( size ); }
     static void  operator delete( void* ptr ) { mem::dealloc( ptr ); }
 
@@ -25,8 +32,22 @@ public:
     template< typename Self > constexpr
     auto type_name( this Self&& ) noexcept { return aer::type_name< Self >(); }
 
-    template< typename Self > constexpr
-    bool is_compatible( this Self&&, const std::type_info& type ) noexcept { return typeid( Self ) == type; }
+    // ancestor table of the dynamic type, overridden by every inherit<>
+    virtual std::span<const type_id_t> type_ids() const noexcept { return type_ancestors; }
+
+    type_id_t type_id() const noexcept { return type_ids().back(); }
+
+    // dense index of the dynamic type, read without a virtual call, see static_dispatch.h
+    type_index_t type_index() const noexcept { return _typeIndex; }
+
+    // constant time check that the dynamic type is T or derives from T
+    template< std::derived_from<Object> T >
+    bool is_compatible() const noexcept
+    {
+        static_assert( T::type_ancestors.back() == aer::type_id<T>(), "T must derive through aer::inherit<T, base_t>" );
+        const auto ids = type_ids();
+        return ids.size() > T::type_depth && ids[T::type_depth] == T::type_ancestors.back();
+    }
 
     template< typename Self, typename V > constexpr
     void accept( this Self&& self, V& visitor ) { visitor.visit( self ); }
@@ -54,7 +75,10 @@ protected:
 protected:
     template< typename T >
     friend class ref_ptr;
-    
+
+    // set by every inherit<> constructor, so the most derived one wins; fills the padding after _references
+    type_index_t _typeIndex = 0;
+
 private:
     mutable std::atomic_uint32_t _references;
 };
@@ -65,4 +89,17 @@ constexpr inline ref_ptr<T> create( Args&&... args ) noexcept
     return ref_ptr{ new T(std::forward<Args>( args )...) };
 };
 
+// checked downcast, returns nullptr when the object is not compatible with T
+template< std::derived_from<Object> T, std::derived_from<Object> R >
+inline T* cast( R* object ) noexcept
+{
+    return ( object && object->template is_compatible<T>() ) ? static_cast<T*>( object ) : nullptr;
+}
+
+template< std::derived_from<Object> T, std::derived_from<Object> R >
+inline ref_ptr<T> cast( const ref_ptr<R>& object ) noexcept
+{
+    return ref_ptr<T>( cast<T>( object.get() ) );
+}
+
 } // namespace aer
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "object.h"
+
+namespace aer
+{
+
+template< typename... Ts >
+struct type_list
+{
+    static constexpr std::size_t size = sizeof...( Ts );
+};
+
+// Recovers the concrete type of an Object from a compile time list of candidates.
+// Each visitor type owns a jump table indexed by Object::type_index(); an entry is resolved to the most
+// derived listed type on the first object of that dynamic type, after which dispatch is one table load
+// and an indirect call with no virtual calls or ancestor walks.
+template< typename List, typename V >
+class static_dispatcher;
+
+template< typename... Ts, typename V >
+class static_dispatcher< type_list<Ts...>, V >
+{
+public:
+    constexpr static std::size_t TABLE_SIZE = 1024;
+
+    // calls static_cast<T&>( object ).accept( visitor ), returns false when no listed T matches
+    static bool dispatch( Object& object, V& visitor )
+    {
+        const auto index = object.type_index();
+        if( index >= TABLE_SIZE ) [[unlikely]] return invoke( resolve( object ), object, visitor );
+
+        auto thunk = _table[index].load( std::memory_order_acquire );
+        if( !thunk ) [[unlikely]]
+        {
+            // racing threads resolve the same entry, so a plain store is enough
+            thunk = resolve( object );
+            _table[index].store( thunk, std::memory_order_release );
+        }
+        return invoke( thunk, object, visitor );
+    }
+
+private:
+    using thunk_t = void(*)( Object&, V& );
+
+    template< typename T >
+    static void visit( Object& object, V& visitor ) { static_cast<T&>( object ).accept( visitor ); }
+    static void unmatched( Object&, V& ) {}
+
+    static bool invoke( thunk_t thunk, Object& object, V& visitor )
+    {
+        thunk( object, visitor );
+        return thunk != &unmatched;
+    }
+
+    static thunk_t resolve( const Object& object ) noexcept
+    {
+        thunk_t     thunk = &unmatched;
+        std::size_t depth = 0;
+        ( ( object.template is_compatible<Ts>() && ( thunk == &unmatched || Ts::type_depth > depth )
+            ? ( thunk = &visit<Ts>, depth = Ts::type_depth, true ) : false ), ... );
+        return thunk;
+    }
+
+    static inline std::array<std::atomic<thunk_t>, TABLE_SIZE> _table{};
+};
+
+// e.g. static_visit<type_list<Group, Node>>( *child, visitor )
+template< typename List, typename V >
+inline bool static_visit( Object& object, V& visitor )
+{
+    return static_dispatcher<List, V>::dispatch( object, visitor );
+}
+
+} // namespace aer
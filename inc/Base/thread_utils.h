@@ -3,45 +3,106 @@
 #include <utility>
 #include <string>
 #include <thread>
+#include <array>
 #include <atomic>
+#include <memory>
 #include <vector>
 
-#include "log.h"
+#include "interfaces/singleton.h"
 
 namespace aer { namespace utils
-{   
-
-static size_t num_threads()
 {
-    static size_t num_threads = [] -> size_t
-    {
-        if( const auto num = std::getenv("NUM_THREADS") ) return std::stoi( num ) + 1;
-        else return std::thread::hardware_concurrency() + 1;
-    }();
-    return num_threads;
-}
 
-struct thread_id_t
+using thread_index_t = uint32_t;
+
+// hardware threads plus one, or NUM_THREADS plus one when set
+size_t num_threads();
+
+// Lock-free array that grows in fixed chunks; elements never move, so references stay valid.
+template< typename T, size_t CHUNK_SIZE = 64, size_t MAX_CHUNKS = 1024 >
+class chunked_array
 {
-    static std::vector<std::atomic_bool> in_use;
+public:
+    constexpr static size_t CAPACITY = CHUNK_SIZE * MAX_CHUNKS;
+
+    chunked_array() = default;
+    ~chunked_array() { for( auto& chunk : _chunks ) delete[] chunk.load( std::memory_order_relaxed ); }
 
-    const int id;
-    const int operator ()() { return id; }
+    chunked_array( const chunked_array& )              = delete;
+    chunked_array& operator = ( const chunked_array& ) = delete;
 
-    thread_id_t() :
-    id([]{
-        for( int i = 0; i < num_threads(); i++ )
+    // allocates the chunk holding index on first use, index must be below CAPACITY
+    T& operator[]( size_t index )
+    {
+        auto& chunk = _chunks[index / CHUNK_SIZE];
+        auto  data  = chunk.load( std::memory_order_acquire );
+        if( !data ) [[unlikely]]
         {
-            bool expected = false;
-            if( !in_use[i] && in_use[i].compare_exchange_strong( expected, true ) ) return i;
+            auto fresh = new T[CHUNK_SIZE]{};
+            if( chunk.compare_exchange_strong( data, fresh, std::memory_order_acq_rel, std::memory_order_acquire ) ) data = fresh;
+            else delete[] fresh;
         }
-        ABORT_F( "More than %d threads created", num_threads() );
-    }()){}
+        return data[index % CHUNK_SIZE];
+    }
+
+    // nullptr while the chunk holding index has not been touched
+    T* find( size_t index ) const noexcept
+    {
+        if( index >= CAPACITY ) return nullptr;
+        auto data = _chunks[index / CHUNK_SIZE].load( std::memory_order_acquire );
+        return data ? &data[index % CHUNK_SIZE] : nullptr;
+    }
+
+private:
+    std::array<std::atomic<T*>, MAX_CHUNKS> _chunks{};
+};
 
-    ~thread_id_t() { in_use[id].store( false ); }
+// Hands out small dense thread ids and recycles them when threads exit.
+// Free ids are kept on a tagged lock-free stack, new ids are only minted once it is empty, so
+// size() stays close to the peak number of live threads.
+class ThreadRegistry : public ISingleton<ThreadRegistry>
+{
+public:
+    constexpr static thread_index_t MAX_THREADS = chunked_array<std::atomic<thread_index_t>>::CAPACITY;
+
+    thread_index_t acquire();
+    void           release( thread_index_t id ) noexcept;
+
+    // one past the highest id handed out so far, bounds every per thread table
+    thread_index_t size()   const noexcept { return _minted.load( std::memory_order_acquire ); }
+    size_t         active() const noexcept { return _active.load( std::memory_order_relaxed ); }
+
+private:
+    // low half holds id + 1 of the top entry, or 0 when empty, the high half is an ABA tag
+    std::atomic<uint64_t>                       _free   = 0;
+    std::atomic<thread_index_t>                 _minted = 0;
+    std::atomic<size_t>                         _active = 0;
+    chunked_array<std::atomic<thread_index_t>>  _links;
 };
 
-std::vector<std::atomic_bool>   thread_id_t::in_use( num_threads() );
-const thread_local thread_id_t  thread_id{};
+// dense id of the calling thread, registered on first use and recycled when the thread exits
+thread_index_t thread_id() noexcept;
+
+// One T per thread id, reached in constant time.
+// An entry outlives its thread and is handed to the next thread that receives the id, so counters
+// keep their totals and components reset whatever must not carry over.
+template< typename T >
+class PerThread
+{
+public:
+    T& local()                          { return _slots[thread_id()]; }
+    T& operator[]( thread_index_t id )  { return _slots[id]; }
+
+    // visits the entries of every id touched so far, concurrent with owners updating them
+    template< typename F > requires std::invocable<F, thread_index_t, T&>
+    void for_each( F&& fn )
+    {
+        const auto size = ThreadRegistry::instance().size();
+        for( thread_index_t id = 0; id < size; ++id ) if( auto slot = _slots.find( id ) ) fn( id, *slot );
+    }
+
+private:
+    chunked_array<T> _slots;
+};
 
-} } // namespace aer::utils
\ No newline at end of file
+} } // namespace aer::utils
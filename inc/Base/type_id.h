@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace aer
+{
+
+using type_id_t    = uint64_t;
+using type_index_t = uint32_t;
+
+namespace detail
+{
+
+// the compiler generated signature embeds the fully qualified name of T
+template< typename T > constexpr
+const char* type_signature() noexcept
+{
+#if defined( _MSC_VER ) && !defined( __clang__ )
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+// 64 bit FNV-1a
+constexpr type_id_t fnv1a( std::string_view str ) noexcept
+{
+    type_id_t hash = 0xcbf29ce484222325ull;
+    for( auto c : str ) { hash ^= static_cast<uint8_t>( c ); hash *= 0x100000001b3ull; }
+    return hash;
+}
+
+inline type_index_t next_type_index() noexcept
+{
+    static std::atomic<type_index_t> next = 1;
+    return next.fetch_add( 1, std::memory_order_relaxed );
+}
+
+} // namespace aer::detail
+
+// Compile time identifier of T, stable across translation units and free of RTTI.
+template< typename T > constexpr type_id_t type_id() noexcept
+{
+    constexpr type_id_t id = detail::fnv1a( detail::type_signature< std::remove_cvref_t<T> >() );
+    return id;
+}
+
+// Dense per process index of T, handed out on first use; 0 is left to the root Object.
+// Unlike type_id() it is not stable between runs, but small enough to index tables with.
+template< typename T > type_index_t type_index() noexcept
+{
+    if constexpr( !std::is_same_v<T, std::remove_cvref_t<T>> ) return type_index< std::remove_cvref_t<T> >();
+    else
+    {
+        static const type_index_t index = detail::next_type_index();
+        return index;
+    }
+}
+
+} // namespace aer
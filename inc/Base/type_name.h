@@ -1,14 +1,64 @@
 #pragma once
 
+#include <array>
+#include <string_view>
+
+#include "type_id.h"
+
 namespace aer
 {
+namespace detail
+{
+
+// the compiler signature of a known type tells us where the type name starts and ends
+constexpr std::string_view type_name_probe = "double";
+
+constexpr std::size_t type_name_prefix() noexcept
+{
+    return std::string_view{ type_signature<double>() }.find( type_name_probe );
+}
+
+constexpr std::size_t type_name_suffix() noexcept
+{
+    return std::string_view{ type_signature<double>() }.size() - type_name_prefix() - type_name_probe.size();
+}
+
+template< typename T > constexpr
+std::string_view type_name_view() noexcept
+{
+    std::string_view name = type_signature<T>();
+    name.remove_prefix( type_name_prefix() );
+    name.remove_suffix( type_name_suffix() );
+
+    // msvc spells out the kind of class types
+    for( std::string_view kind : { "struct ", "class ", "union ", "enum " } )
+    {
+        if( name.starts_with( kind ) ) { name.remove_prefix( kind.size() ); break; }
+    }
+    return name;
+}
+
+// null terminated copy of the demangled name with static storage duration
+template< typename T >
+struct type_name_storage
+{
+    static constexpr auto view  = type_name_view<T>();
+    static constexpr auto value = []
+    {
+        std::array<char, view.size() + 1> str{};
+        for( std::size_t i = 0; i < view.size(); ++i ) str[i] = view[i];
+        return str;
+    }();
+};
+
+} // namespace aer::detail
 
-template< typename T > constexpr auto type_name()            noexcept { return typeid(T).name(); }
-template< typename T > constexpr auto type_name( T& )        noexcept { return type_name<T>(); }
-template< typename T > constexpr auto type_name( const T& )  noexcept { return type_name<const T>(); }     
+template< typename T > constexpr const char* type_name()            noexcept { return detail::type_name_storage<T>::value.data(); }
+template< typename T > constexpr const char* type_name( T& )        noexcept { return type_name<T>(); }
+template< typename T > constexpr const char* type_name( const T& )  noexcept { return type_name<const T>(); }
 
 #define AER_TYPE_NAME( T )\
-template<> auto type_name<T>()         noexcept { return #T; }\
-template<> auto type_name<const T>()   noexcept { return "const "#T; }
+template<> constexpr const char* type_name<T>()         noexcept { return #T; }\
+template<> constexpr const char* type_name<const T>()   noexcept { return "const "#T; }
 
-}
\ No newline at end of file
+}
@@ -1,61 +1,123 @@
 #include <Base/memory/Allocator.h>
 #include <Base/memory/MemoryBlocks.h>
+#include <Base/memory/Manager.h>
+#include <Base/deferred_log.h>
+#include <Base/Profiler.h>
 
 #include <loguru.hpp>
 #include <mutex>
+#include <new>
 
 namespace aer::mem
 {
     
 Allocator::Allocator()
 {
-    DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::Allocator() - Allocator created." );
+    DEFERRED_DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::Allocator() - Allocator created." );
 
     _memoryBlocks.resize( ALLOCATOR_AFFINITY_LAST );
-    _memoryBlocks[ALLOCATOR_AFFINITY_OBJECTS].reset( new MemoryBlocks{ this } );
+    for( auto& memoryBlocks : _memoryBlocks ) memoryBlocks.reset( new MemoryBlocks{ this } );
 }
 
-std::unique_ptr<Allocator>& Allocator::instance() noexcept
+Allocator::~Allocator()
 {
-    static auto allocator = std::make_unique<Allocator>(); 
-    return allocator;
-}
+    if( auto manager = this->manager() ) manager->detach( *this );
 
-void* Allocator::allocate( std::size_t size, AllocatorAffinity affinity )
-{
+    // arenas still holding allocations or never released go back with the allocator, like its blocks
     std::scoped_lock lock( _mutex );
-    switch ( policy )
+    for( auto& [memory, arena] : _arenas )
     {
-        case ALLOCATOR_POLICY_STD_NEW_DELETE:     return operator new( size );
-        case ALLOCATOR_POLICY_STD_MALLOC_FREE:    return std::malloc(  size );
-        default:                                  break;
+        DEFERRED_DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::~Allocator() - Arena %p freed with %zu live allocations.", arena.get(), arena->live() );
+        free_arena( *arena );
     }
+    _arenas.clear();
+}
 
-    if( affinity > _memoryBlocks.size() )
+void* Allocator::allocate( std::size_t size, AllocatorAffinity affinity, const void* hint )
+{
+    AER_PROFILE_SCOPE( "mem::Allocator::allocate" );
+    size_t growth  = 0;
+    bool   refused = false;
     {
-        DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::allocate( %zu, %hhu ) - Creating new memory_block.", size, affinity );
-        _memoryBlocks.resize( affinity + 1 );
-        _memoryBlocks[affinity].reset( new MemoryBlocks{ this } );
+        std::scoped_lock lock( _mutex );
+
+        // arenas are explicit, so they take precedence over the policy
+        if( auto arena = current_arena(); arena && arena->affinity == affinity && !arena->_released )
+        {
+            auto offset = ( arena->used() + MemoryBlock::ALIGNMENT - 1 ) & ~( MemoryBlock::ALIGNMENT - 1 );
+            if( offset + size <= arena->capacity )
+            {
+                arena->_used.store( offset + size, std::memory_order_relaxed );
+                arena->_live.fetch_add( 1, std::memory_order_relaxed );
+                return arena->_memory + offset;
+            }
+            DEFERRED_DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::allocate( %zu, %hhu ) - Arena %p is full.", size, affinity, arena );
+        }
+
+        switch ( policy )
+        {
+            case ALLOCATOR_POLICY_STD_NEW_DELETE:     return operator new( size );
+            case ALLOCATOR_POLICY_STD_MALLOC_FREE:    return std::malloc(  size );
+            default:                                  break;
+        }
+
+        if( affinity >= _memoryBlocks.size() )
+        {
+            DEFERRED_DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::allocate( %zu, %hhu ) - Creating new memory_block.", size, affinity );
+            _memoryBlocks.resize( affinity + 1 );
+        }
+
+        auto& memoryBlocks = _memoryBlocks[affinity];
+        if( !memoryBlocks ) memoryBlocks.reset( new MemoryBlocks{ this } );
+        if( auto ptr = memoryBlocks->allocate( size, hint ) )
+        {
+            DEFERRED_DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::allocate( %zu, %hhu ) - Allocated from latest memory_block.", size, affinity );
+            return ptr;
+        }
+        growth = memoryBlocks->growth( size );
+        refused = !_growthAllowed;
     }
 
-    auto& memoryBlocks = _memoryBlocks[affinity];
-    if( memoryBlocks )
+    if( refused )
     {
-        auto ptr = memoryBlocks->allocate( size );
-        if( ptr )
+        growth_refused( size, affinity );
         {
-            DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::allocate( %zu, %hhu ) - Allocated from latest memory_block.", size, affinity );
-            return ptr;
+            std::scoped_lock lock( _mutex );
+            if( auto ptr = _memoryBlocks[affinity]->allocate( size, hint ) ) return ptr;
         }
+        LOG_F( ERROR, "Allocator::allocate( %zu, %hhu ) - Preallocated memory exhausted and onGrowthFailure freed none.", size, affinity );
+        throw std::bad_alloc();
+    }
+
+    // the budget is asked without the lock, so pressure callbacks may free memory through this allocator
+    auto manager = this->manager();
+    if( manager && !manager->reserve( affinity, growth ) )
+    {
+        LOG_F( WARNING, "Allocator::allocate( %zu, %hhu ) - %zu bytes of growth refused by the memory budget.", size, affinity, growth );
+        throw std::bad_alloc();
     }
 
-    if( memoryBlocks->_blocks.empty() ) ABORT_F( "Allocator::allocate( %zu, %hhu ) - No memory_block available.", size, affinity );
-    return nullptr;
+    std::scoped_lock lock( _mutex );
+    auto& memoryBlocks = _memoryBlocks[affinity];
+
+    // another thread may have grown in the meantime
+    if( auto ptr = memoryBlocks->allocate( size, hint ) )
+    {
+        if( manager ) manager->release( affinity, growth );
+        return ptr;
+    }
+
+    auto ptr = memoryBlocks->grow( size );
+    if( !ptr ) ABORT_F( "Allocator::allocate( %zu, %hhu ) - No memory_block available.", size, affinity );
+    return ptr;
 }
 
 bool Allocator::deallocate( void* ptr, std::size_t size )
 {
+    AER_PROFILE_SCOPE( "mem::Allocator::deallocate" );
     std::scoped_lock lock( _mutex );
+    if( !_arenas.empty() && deallocate_arena( ptr ) ) return true;
+
     switch ( policy )
     {
         case ALLOCATOR_POLICY_NO_DELETE:                                return true;
@@ -67,11 +129,157 @@ bool Allocator::deallocate( void* ptr, std::size_t size )
     for( auto& memoryBlocks : _memoryBlocks )
     {
         if( memoryBlocks && memoryBlocks->deallocate( ptr, size ) )
-        DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::deallocate( %p, %zu ) - Deallocated from memory block", ptr, size );
-        return true;
+        {
+            DEFERRED_DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::deallocate( %p, %zu ) - Deallocated from memory block", ptr, size );
+            return true;
+        }
     }
 
     return false;
 }
 
+Arena* Allocator::create_arena( std::size_t capacity, AllocatorAffinity affinity )
+{
+    if( !growth_allowed() )
+    {
+        growth_refused( capacity, affinity );
+        return nullptr;
+    }
+    if( auto manager = this->manager(); manager && !manager->reserve( affinity, capacity ) ) return nullptr;
+
+    auto arena = std::unique_ptr<Arena>( new Arena{ affinity, capacity } );
+    arena->_memory = static_cast<uint8_t*>( operator new( capacity, std::align_val_t{ MemoryBlock::ALIGNMENT } ) );
+    DEFERRED_DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::create_arena( %zu, %hhu ) - Arena %p created.", capacity, affinity, arena.get() );
+
+    std::scoped_lock lock( _mutex );
+    auto& slot = _arenas[arena->_memory];
+    slot = std::move( arena );
+    return slot.get();
+}
+
+void Allocator::release_arena( Arena* arena )
+{
+    if( !arena ) return;
+
+    std::scoped_lock lock( _mutex );
+    arena->_released = true;
+    if( arena->live() > 0 ) return;
+
+    DEFERRED_DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::release_arena( %p ) - %zu bytes freed.", arena, arena->capacity );
+    free_arena( *arena );
+    _arenas.erase( arena->_memory );
+}
+
+// called with _mutex held
+bool Allocator::deallocate_arena( void* ptr )
+{
+    auto itr = _arenas.upper_bound( ptr );
+    if( itr == _arenas.begin() ) return false;
+
+    auto& arena = std::prev( itr )->second;
+    if( ptr >= arena->_memory + arena->capacity ) return false;
+
+    // the last allocation of a released arena frees the whole region
+    if( arena->_live.fetch_sub( 1, std::memory_order_relaxed ) == 1 && arena->_released )
+    {
+        DEFERRED_DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::deallocate( %p ) - Arena %p freed.", ptr, arena.get() );
+        free_arena( *arena );
+        _arenas.erase( std::prev( itr ) );
+    }
+    return true;
+}
+
+// called with _mutex held
+void Allocator::free_arena( Arena& arena ) noexcept
+{
+    operator delete( arena._memory, std::align_val_t{ MemoryBlock::ALIGNMENT } );
+    if( auto manager = this->manager() ) manager->release( arena.affinity, arena.capacity );
+}
+
+size_t Allocator::trim( AllocatorAffinity affinity )
+{
+    size_t freed = 0;
+    {
+        // blocks given back now could not be replaced
+        std::scoped_lock lock( _mutex );
+        if( _growthAllowed && affinity < _memoryBlocks.size() && _memoryBlocks[affinity] ) freed = _memoryBlocks[affinity]->trim();
+    }
+
+    if( auto manager = this->manager(); manager && freed ) manager->release( affinity, freed );
+    return freed;
+}
+
+size_t Allocator::trim()
+{
+    size_t affinities = 0;
+    {
+        std::scoped_lock lock( _mutex );
+        affinities = _memoryBlocks.size();
+    }
+
+    size_t freed = 0;
+    for( size_t affinity = 0; affinity < affinities; ++affinity ) freed += trim( static_cast<AllocatorAffinity>( affinity ) );
+    return freed;
+}
+
+size_t Allocator::backing_size( AllocatorAffinity affinity ) const
+{
+    std::scoped_lock lock( _mutex );
+    size_t size = affinity < _memoryBlocks.size() && _memoryBlocks[affinity] ? _memoryBlocks[affinity]->totalMemorySize() : 0;
+    for( auto& [memory, arena] : _arenas ) if( arena->affinity == affinity ) size += arena->capacity;
+    return size;
+}
+
+bool Allocator::make_deterministic( const DeterministicConfig& config )
+{
+    {
+        std::scoped_lock lock( _mutex );
+        if( policy == ALLOCATOR_POLICY_STD_NEW_DELETE || policy == ALLOCATOR_POLICY_STD_MALLOC_FREE )
+        {
+            LOG_F( ERROR, "Allocator::make_deterministic() - policy %hhu does not allocate from blocks.", policy );
+            return false;
+        }
+    }
+
+    bool complete = true;
+    for( size_t affinity = 0; affinity < config.blocks.size(); ++affinity )
+    {
+        for( size_t i = 0; i < config.blocks[affinity]; ++i ) complete &= preallocate( static_cast<AllocatorAffinity>( affinity ), config.lockPages );
+    }
+
+    std::scoped_lock lock( _mutex );
+    _growthAllowed = config.allowGrowth;
+    LOG_F( INFO, "Allocator::make_deterministic() - blocks preallocated%s, growth %s.", config.lockPages ? " and locked" : "", _growthAllowed ? "allowed" : "refused" );
+    return complete;
+}
+
+bool Allocator::growth_allowed() const
+{
+    std::scoped_lock lock( _mutex );
+    return _growthAllowed;
+}
+
+bool Allocator::preallocate( AllocatorAffinity affinity, bool lock )
+{
+    size_t size = 0;
+    {
+        std::scoped_lock guard( _mutex );
+        if( affinity >= _memoryBlocks.size() ) _memoryBlocks.resize( affinity + 1 );
+        if( !_memoryBlocks[affinity] ) _memoryBlocks[affinity].reset( new MemoryBlocks{ this } );
+        size = _memoryBlocks[affinity]->blockSize;
+    }
+
+    if( auto manager = this->manager(); manager && !manager->reserve( affinity, size ) ) return false;
+
+    std::scoped_lock guard( _mutex );
+    return _memoryBlocks[affinity]->preallocate( lock );
+}
+
+// called without _mutex held, so the hook may free memory
+void Allocator::growth_refused( std::size_t size, AllocatorAffinity affinity )
+{
+    LOG_F( WARNING, "Allocator - %zu bytes of affinity %hhu refused, growth is disabled and the preallocated memory is exhausted.", size, affinity );
+    if( onGrowthFailure ) onGrowthFailure( size, affinity );
+}
+
 } // namespace aer::mem
@@ -0,0 +1,82 @@
+#include <Base/EventBus.h>
+#include <loguru.hpp>
+
+namespace aer
+{
+
+EventBus::EventBus( utils::JobSystem& jobs ) : _jobs( jobs ) {}
+
+EventBus::~EventBus()
+{
+    // jobs still hold this bus
+    _jobs.wait( _counter );
+}
+
+ref_ptr<EventBus::Channel> EventBus::Attach( Handler handler, EventLane lane, size_t capacity )
+{
+    return Channel::create( [handler = std::move( handler )]( Event& event ){ handler( event ); return true; }, lane, capacity );
+}
+
+ref_ptr<EventBus::Channel> EventBus::Attach( EventDispatcher& dispatcher, EventLane lane, size_t capacity )
+{
+    return Channel::create( [&dispatcher]( Event& event ){ return dispatcher.Dispatch( event ); }, lane, capacity );
+}
+
+void EventBus::Schedule( Channel& channel )
+{
+    // only the poster that flips the flag queues the channel, the job holding it picks up the rest
+    if( channel._scheduled.exchange( true, std::memory_order_acq_rel ) ) return;
+    Ready( ref_ptr<Channel>( &channel ) );
+}
+
+// every ready channel is matched by one job, which serves whichever channel ranks highest when it starts
+void EventBus::Ready( ref_ptr<Channel> channel )
+{
+    {
+        std::scoped_lock lock( _mutex );
+        _lanes[channel->lane].emplace_back( std::move( channel ) );
+    }
+    _jobs.run( _counter, [this]{ Run(); } );
+}
+
+void EventBus::Drain( Channel& channel )
+{
+    // a Post that passed the closed check may still be writing its cell, so only published events are discarded
+    if( channel._closed.load( std::memory_order_acquire ) ) channel._events.consume( []( EventStorage& ){} );
+    else channel._events.consume( [&]( EventStorage& event ){ EventStats::Deliver( *event, event.sent(), channel._handler ); }, DEFAULT_BATCH_SIZE );
+
+    // requeue behind other ready channels of the same lane while events remain
+    bool requeue = !channel._events.empty();
+    if( !requeue )
+    {
+        channel._scheduled.store( false, std::memory_order_release );
+
+        // an event published after the emptiness check saw the flag still set and did not schedule us
+        requeue = !channel._events.empty() && !channel._scheduled.exchange( true, std::memory_order_acq_rel );
+    }
+
+    if( requeue ) Ready( ref_ptr<Channel>( &channel ) );
+}
+
+void EventBus::Run()
+{
+    ref_ptr<Channel> channel;
+    {
+        std::scoped_lock lock( _mutex );
+        for( auto& lane : _lanes )
+        {
+            if( lane.empty() ) continue;
+            channel = std::move( lane.front() );
+            lane.pop_front();
+            break;
+        }
+    }
+    if( channel ) Drain( *channel );
+}
+
+void EventBus::Flush()
+{
+    _jobs.wait( _counter );
+}
+
+} // namespace aer
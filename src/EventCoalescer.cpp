@@ -0,0 +1,75 @@
+#include <Base/EventCoalescer.h>
+#include <Base/EventStats.h>
+
+#include <algorithm>
+
+namespace aer
+{
+
+void EventCoalescer::Coalesce( type_id_t type, Key key, Merge merge )
+{
+    _coalescers[type] = Coalescer{ std::move( key ), std::move( merge ) };
+}
+
+EventCoalescer::filter_t EventCoalescer::AddFilter( Predicate predicate )
+{
+    auto id = _nextFilter++;
+    _filters.emplace_back( id, std::move( predicate ) );
+    return id;
+}
+
+bool EventCoalescer::RemoveFilter( filter_t filter )
+{
+    return std::erase_if( _filters, [=]( auto& entry ){ return entry.first == filter; } ) > 0;
+}
+
+void EventCoalescer::Process( std::vector<Event*>& batch )
+{
+    if( !_filters.empty() )
+    {
+        for( auto& event : batch )
+        {
+            if( !event ) continue;
+            for( auto& [id, predicate] : _filters )
+            {
+                if( predicate( *event ) ) continue;
+                EventStats::Discarded( *event );
+                event = nullptr;
+                break;
+            }
+        }
+    }
+
+    if( _coalescers.empty() ) return;
+
+    // group events by type and key, the last of each group survives
+    _entries.clear();
+    for( size_t i = 0; i < batch.size(); ++i )
+    {
+        if( !batch[i] ) continue;
+
+        auto type = batch[i]->type_id();
+        auto itr  = _coalescers.find( type );
+        if( itr != _coalescers.end() ) _entries.push_back( Entry{ type, itr->second.key( *batch[i] ), i } );
+    }
+    std::sort( _entries.begin(), _entries.end() );
+
+    for( size_t first = 0; first < _entries.size(); )
+    {
+        size_t last = first;
+        while( last + 1 < _entries.size() && _entries[last + 1].type == _entries[first].type && _entries[last + 1].key == _entries[first].key ) ++last;
+
+        auto& newest = *batch[_entries[last].index];
+        auto& merge  = _coalescers.find( _entries[first].type )->second.merge;
+        for( size_t i = first; i < last; ++i )
+        {
+            auto& older = batch[_entries[i].index];
+            if( merge ) merge( newest, *older );
+            EventStats::Discarded( *older );
+            older = nullptr;
+        }
+        first = last + 1;
+    }
+}
+
+} // namespace aer
@@ -0,0 +1,55 @@
+#include <Base/EventDispatcher.h>
+
+#include <algorithm>
+
+namespace aer
+{
+
+EventDispatcher::subscription_t EventDispatcher::Subscribe( type_id_t type, Handler handler, int priority )
+{
+    auto& slot        = _subscribers[type];
+    auto  subscribers = slot ? std::make_shared<Subscribers>( *slot ) : std::make_shared<Subscribers>();
+    auto  position    = std::upper_bound( subscribers->begin(), subscribers->end(), priority, []( int priority, const Subscriber& subscriber )
+    {
+        return priority > subscriber.priority;
+    });
+
+    auto id = _nextSubscription++;
+    subscribers->insert( position, Subscriber{ id, priority, std::move( handler ) } );
+    slot = std::move( subscribers );
+    return id;
+}
+
+bool EventDispatcher::Unsubscribe( subscription_t subscription )
+{
+    for( auto itr = _subscribers.begin(); itr != _subscribers.end(); ++itr )
+    {
+        auto& slot  = itr->second;
+        auto  match = std::find_if( slot->begin(), slot->end(), [=]( const Subscriber& subscriber ){ return subscriber.id == subscription; } );
+        if( match == slot->end() ) continue;
+
+        if( slot->size() == 1 ) { _subscribers.erase( itr ); return true; }
+
+        auto subscribers = std::make_shared<Subscribers>( *slot );
+        subscribers->erase( subscribers->begin() + ( match - slot->begin() ) );
+        slot = std::move( subscribers );
+        return true;
+    }
+    return false;
+}
+
+bool EventDispatcher::Dispatch( Event& event ) const
+{
+    auto itr = _subscribers.find( event.type_id() );
+    if( itr == _subscribers.end() ) return false;
+
+    // handlers that change subscriptions replace the list, this one stays alive until the loop ends
+    auto subscribers = itr->second;
+    bool handled     = false;
+    for( auto& subscriber : *subscribers ) handled |= subscriber.handler( event );
+
+    event._handled |= handled;
+    return handled;
+}
+
+} // namespace aer
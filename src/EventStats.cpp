@@ -0,0 +1,77 @@
+#include <Base/EventStats.h>
+#include <Base/TypeRegistry.h>
+
+namespace aer
+{
+
+std::array<EventStats::Slot, EventStats::MAX_TYPES> EventStats::_slots;
+
+// open addressing on the type id, slots are claimed once and never released
+EventStats::Slot* EventStats::find( type_id_t type ) noexcept
+{
+    for( size_t probe = 0; probe < MAX_TYPES; ++probe )
+    {
+        auto& slot     = _slots[( type + probe ) % MAX_TYPES];
+        auto  expected = slot.type.load( std::memory_order_acquire );
+        if( expected == type ) return &slot;
+        if( expected == 0 )
+        {
+            if( slot.type.compare_exchange_strong( expected, type, std::memory_order_acq_rel ) || expected == type ) return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void EventStats::Count( type_id_t type, std::atomic<uint64_t> Slot::* counter ) noexcept
+{
+    if( auto slot = find( type ) ) ( slot->*counter ).fetch_add( 1, std::memory_order_relaxed );
+}
+
+void EventStats::Record( type_id_t type, uint64_t sent, uint64_t start, uint64_t end, bool handled ) noexcept
+{
+    auto slot = find( type );
+    if( !slot ) return;
+
+    slot->delivered.fetch_add( 1, std::memory_order_relaxed );
+    if( !handled ) slot->unhandled.fetch_add( 1, std::memory_order_relaxed );
+    if( sent && sent <= start ) slot->queueLatency[EventHistogram::bucket( start - sent )].fetch_add( 1, std::memory_order_relaxed );
+    slot->handlerTime[EventHistogram::bucket( end - start )].fetch_add( 1, std::memory_order_relaxed );
+}
+
+std::vector<EventTypeStats> EventStats::snapshot()
+{
+    std::vector<EventTypeStats> snapshot;
+    for( auto& slot : _slots )
+    {
+        auto type = slot.type.load( std::memory_order_acquire );
+        if( type == 0 ) continue;
+
+        EventTypeStats stats;
+        stats.type      = type;
+        stats.name      = TypeRegistry::instance().name( type );
+        stats.sent      = slot.sent.load( std::memory_order_relaxed );
+        stats.delivered = slot.delivered.load( std::memory_order_relaxed );
+        stats.unhandled = slot.unhandled.load( std::memory_order_relaxed );
+        stats.dropped   = slot.dropped.load( std::memory_order_relaxed );
+        stats.discarded = slot.discarded.load( std::memory_order_relaxed );
+        for( size_t i = 0; i < EventHistogram::BUCKETS; ++i )
+        {
+            stats.queueLatency.counts[i] = slot.queueLatency[i].load( std::memory_order_relaxed );
+            stats.handlerTime.counts[i]  = slot.handlerTime[i].load( std::memory_order_relaxed );
+        }
+        snapshot.push_back( stats );
+    }
+    return snapshot;
+}
+
+void EventStats::reset() noexcept
+{
+    for( auto& slot : _slots )
+    {
+        for( auto counter : { &slot.sent, &slot.delivered, &slot.unhandled, &slot.dropped, &slot.discarded } ) counter->store( 0, std::memory_order_relaxed );
+        for( auto& count : slot.queueLatency ) count.store( 0, std::memory_order_relaxed );
+        for( auto& count : slot.handlerTime )  count.store( 0, std::memory_order_relaxed );
+    }
+}
+
+} // namespace aer
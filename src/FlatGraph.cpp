@@ -0,0 +1,71 @@
+#include <Base/nodes/FlatGraph.h>
+#include <loguru.hpp>
+
+namespace aer
+{
+
+ref_ptr<FlatGraph> FlatGraph::compile( const ref_ptr<Node>& root )
+{
+    auto graph = FlatGraph::create();
+    if( !root ) return graph;
+
+    struct Entry
+    {
+        Node*    node;
+        index_t  parent;
+        uint32_t depth;
+    };
+
+    // explicit stack, children are pushed in reverse so they are popped in order
+    std::vector<Entry> stack{ { root.get(), npos, 0 } };
+    while( !stack.empty() )
+    {
+        auto entry = stack.back();
+        stack.pop_back();
+
+        if( graph->_nodes.size() >= npos )
+        {
+            LOG_F( ERROR, "FlatGraph::compile() - graph exceeds %u nodes.", npos );
+            return {};
+        }
+
+        auto index = graph->size();
+        graph->_types.push_back( entry.node->type_id() );
+        graph->_parents.push_back( entry.parent );
+        graph->_depths.push_back( entry.depth );
+        graph->_nodes.emplace_back( entry.node );
+
+        // a revisited node is not expanded again, so shared subtrees are emitted once and cycles end
+        auto [itr, first] = graph->_indices.try_emplace( entry.node, index );
+        graph->_originals.push_back( itr->second );
+
+        uint32_t count = 0;
+        if( auto group = first ? aer::cast<Group>( entry.node ) : nullptr )
+        {
+            auto children = group->children();
+            for( auto child = children->rbegin(); child != children->rend(); ++child )
+            {
+                if( !*child ) continue;
+                stack.push_back( { child->get(), index, entry.depth + 1 } );
+                ++count;
+            }
+        }
+        graph->_childCounts.push_back( count );
+    }
+
+    // children follow their parent, so one backward pass accumulates every subtree size
+    auto& skips = graph->_skips;
+    skips.assign( graph->size(), 1 );
+    for( index_t i = graph->size(); i-- > 1; ) skips[graph->_parents[i]] += skips[i];
+    for( index_t i = 0; i < graph->size(); ++i ) skips[i] += i;
+
+    return graph;
+}
+
+FlatGraph::index_t FlatGraph::find( const Node* node ) const
+{
+    auto itr = _indices.find( node );
+    return itr != _indices.end() ? itr->second : npos;
+}
+
+} // namespace aer
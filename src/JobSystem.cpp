@@ -0,0 +1,219 @@
+#include <Base/JobSystem.h>
+
+namespace aer::utils
+{
+
+static thread_local const JobSystem* current_system = nullptr;
+static thread_local size_t           current_index  = 0;
+
+// finished jobs are recycled on the thread that ran them
+struct JobCache
+{
+    constexpr static size_t CAPACITY = 1024;
+
+    std::vector<Job*> jobs;
+    ~JobCache() { for( auto job : jobs ) delete job; }
+};
+static thread_local JobCache job_cache;
+
+bool JobDeque::push( Job* job ) noexcept
+{
+    auto bottom = _bottom.load( std::memory_order_relaxed );
+    auto top    = _top.load( std::memory_order_acquire );
+    if( bottom - top >= static_cast<int64_t>( CAPACITY ) ) return false;
+
+    _jobs[bottom & ( CAPACITY - 1 )].store( job, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+    _bottom.store( bottom + 1, std::memory_order_relaxed );
+    return true;
+}
+
+Job* JobDeque::pop() noexcept
+{
+    auto bottom = _bottom.load( std::memory_order_relaxed ) - 1;
+    _bottom.store( bottom, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    auto top = _top.load( std::memory_order_relaxed );
+
+    if( top > bottom )
+    {
+        _bottom.store( bottom + 1, std::memory_order_relaxed );
+        return nullptr;
+    }
+
+    auto job = _jobs[bottom & ( CAPACITY - 1 )].load( std::memory_order_relaxed );
+    if( top == bottom )
+    {
+        // last job, race the thieves for it
+        if( !_top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) job = nullptr;
+        _bottom.store( bottom + 1, std::memory_order_relaxed );
+    }
+    return job;
+}
+
+Job* JobDeque::steal() noexcept
+{
+    auto top = _top.load( std::memory_order_acquire );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    auto bottom = _bottom.load( std::memory_order_acquire );
+    if( top >= bottom ) return nullptr;
+
+    auto job = _jobs[top & ( CAPACITY - 1 )].load( std::memory_order_relaxed );
+    if( !_top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) ) return nullptr;
+    return job;
+}
+
+JobSystem::JobSystem( size_t num_workers )
+{
+    // created first so it is torn down after the workers have been joined
+    ThreadRegistry::instance();
+
+    num_workers = std::max<size_t>( num_workers, 1 );
+    for( size_t i = 0; i < num_workers; ++i ) _deques.emplace_back( std::make_unique<JobDeque>() );
+
+    _workers.reserve( num_workers );
+    for( size_t i = 0; i < num_workers; ++i ) _workers.emplace_back( [this, i]{ work( i ); } );
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::scoped_lock lock( _sleepMutex );
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for( auto& worker : _workers ) worker.join();
+}
+
+size_t JobSystem::worker_index() const noexcept
+{
+    return current_system == this ? current_index : _workers.size();
+}
+
+Job* JobSystem::acquire( std::function<void()>&& function, JobCounter& counter )
+{
+    Job* job = nullptr;
+    if( job_cache.jobs.empty() ) job = new Job;
+    else { job = job_cache.jobs.back(); job_cache.jobs.pop_back(); }
+
+    job->function = std::move( function );
+    job->counter  = &counter;
+    return job;
+}
+
+void JobSystem::run( JobCounter& counter, std::function<void()> function )
+{
+    counter._pending.fetch_add( 1, std::memory_order_relaxed );
+    submit( acquire( std::move( function ), counter ) );
+}
+
+void JobSystem::run_after( JobCounter& dependency, JobCounter& counter, std::function<void()> function )
+{
+    counter._pending.fetch_add( 1, std::memory_order_relaxed );
+    auto job = acquire( std::move( function ), counter );
+    {
+        // the thread that finishes the dependency takes the continuations under the same lock
+        std::scoped_lock lock( dependency._mutex );
+        if( dependency.pending() > 0 ) { dependency._continuations.push_back( job ); return; }
+    }
+    submit( job );
+}
+
+void JobSystem::submit( Job* job )
+{
+    // counted before it can be found, so a thief taking it right away never takes the count below zero
+    _queued.fetch_add( 1, std::memory_order_release );
+
+    auto index = worker_index();
+    if( index < _deques.size() )
+    {
+        // a full deque degrades to running the job right away
+        if( !_deques[index]->push( job ) )
+        {
+            _queued.fetch_sub( 1, std::memory_order_relaxed );
+            execute( job );
+            return;
+        }
+    }
+    else
+    {
+        std::scoped_lock lock( _injectionMutex );
+        _injection.push_back( job );
+    }
+
+    { std::scoped_lock lock( _sleepMutex ); }
+    _wake.notify_one();
+}
+
+Job* JobSystem::find( size_t index )
+{
+    Job* job = index < _deques.size() ? _deques[index]->pop() : nullptr;
+
+    for( size_t i = 1; !job && i <= _deques.size(); ++i ) job = _deques[( index + i ) % _deques.size()]->steal();
+
+    if( !job )
+    {
+        std::scoped_lock lock( _injectionMutex );
+        if( !_injection.empty() ) { job = _injection.front(); _injection.pop_front(); }
+    }
+
+    if( job ) _queued.fetch_sub( 1, std::memory_order_relaxed );
+    return job;
+}
+
+void JobSystem::execute( Job* job )
+{
+    job->function();
+
+    auto counter  = job->counter;
+    job->function = nullptr;
+    if( job_cache.jobs.size() < JobCache::CAPACITY ) job_cache.jobs.push_back( job );
+    else delete job;
+
+    finish( *counter );
+}
+
+void JobSystem::finish( JobCounter& counter )
+{
+    auto pending = counter._pending.load( std::memory_order_relaxed );
+    while( pending > 1 )
+    {
+        if( counter._pending.compare_exchange_weak( pending, pending - 1, std::memory_order_acq_rel, std::memory_order_relaxed ) ) return;
+    }
+
+    // zero is only ever published under the lock, so run_after() can not miss it and a waiter that
+    // locks after observing it knows this thread is done with the counter
+    std::vector<Job*> continuations;
+    {
+        std::scoped_lock lock( counter._mutex );
+        if( counter._pending.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) continuations.swap( counter._continuations );
+    }
+    for( auto continuation : continuations ) submit( continuation );
+}
+
+void JobSystem::wait( JobCounter& counter )
+{
+    auto index = worker_index();
+    while( counter.pending() > 0 )
+    {
+        if( auto job = find( index ) ) execute( job );
+        else std::this_thread::yield();
+    }
+    std::scoped_lock lock( counter._mutex );
+}
+
+void JobSystem::work( size_t index )
+{
+    current_system = this;
+    current_index  = index;
+
+    while( !_stopping.load( std::memory_order_acquire ) )
+    {
+        if( auto job = find( index ) ) { execute( job ); continue; }
+
+        std::unique_lock lock( _sleepMutex );
+        _wake.wait( lock, [&]{ return _stopping.load() || _queued.load( std::memory_order_acquire ) > 0; } );
+    }
+}
+
+} // namespace aer::utils
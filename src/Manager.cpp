@@ -1,11 +1,164 @@
-#include <Base/memory/manager.h>
+#include <Base/memory/Manager.h>
+#include <loguru.hpp>
+
+#include <algorithm>
+#include <mutex>
 
 namespace aer::mem
 {
-std::unique_ptr<Manager>& Manager::instance() noexcept
+
+// a callback that allocates must not raise pressure on its own thread again
+static thread_local bool raising = false;
+
+Manager::Manager()
+{
+    attach( Allocator::instance() );
+}
+
+Manager::~Manager()
+{
+    std::scoped_lock lock( _mutex );
+    for( auto allocator : _allocators ) allocator->_manager.store( nullptr, std::memory_order_release );
+}
+
+bool Manager::attach( Allocator& allocator )
+{
+    {
+        std::scoped_lock lock( _mutex );
+        Manager* expected = nullptr;
+        if( !allocator._manager.compare_exchange_strong( expected, this, std::memory_order_acq_rel ) )
+        {
+            LOG_IF_F( WARNING, expected != this, "Manager::attach( %p ) - allocator is budgeted by another manager.", &allocator );
+            return expected == this;
+        }
+        _allocators.push_back( &allocator );
+    }
+
+    // memory taken before attaching is accounted, but never refused; growth from here on reserves its own
+    for( size_t affinity = 0; affinity < MAX_AFFINITIES; ++affinity )
+    {
+        _accounts[affinity].used.fetch_add( allocator.backing_size( static_cast<AllocatorAffinity>( affinity ) ), std::memory_order_relaxed );
+    }
+    return true;
+}
+
+void Manager::detach( Allocator& allocator ) noexcept
 {
-    static auto manager = std::make_unique<Manager>();
-    return manager;
+    {
+        std::scoped_lock lock( _mutex );
+        auto itr = std::find( _allocators.begin(), _allocators.end(), &allocator );
+        if( itr == _allocators.end() ) return;
+        _allocators.erase( itr );
+        allocator._manager.store( nullptr, std::memory_order_release );
+    }
+
+    for( size_t affinity = 0; affinity < MAX_AFFINITIES; ++affinity )
+    {
+        release( static_cast<AllocatorAffinity>( affinity ), allocator.backing_size( static_cast<AllocatorAffinity>( affinity ) ) );
+    }
+}
+
+void Manager::set_budget( AllocatorAffinity affinity, MemoryBudget budget ) noexcept
+{
+    LOG_IF_F( WARNING, budget.soft > budget.hard, "Manager::set_budget( %hhu ) - soft budget %zu is above the hard budget %zu.", affinity, budget.soft, budget.hard );
+
+    auto& account = _accounts[affinity];
+    account.soft.store( std::min( budget.soft, budget.hard ), std::memory_order_relaxed );
+    account.hard.store( budget.hard, std::memory_order_relaxed );
+}
+
+MemoryBudget Manager::budget( AllocatorAffinity affinity ) const noexcept
+{
+    auto& account = _accounts[affinity];
+    return { account.soft.load( std::memory_order_relaxed ), account.hard.load( std::memory_order_relaxed ) };
+}
+
+MemoryPressure Manager::pressure( AllocatorAffinity affinity ) const noexcept
+{
+    return _accounts[affinity].pressure.load( std::memory_order_relaxed );
+}
+
+Manager::callback_t Manager::add_pressure_callback( PressureCallback callback )
+{
+    std::scoped_lock lock( _mutex );
+    _callbacks.emplace_back( _nextCallback, std::make_shared<PressureCallback>( std::move( callback ) ) );
+    return _nextCallback++;
+}
+
+bool Manager::remove_pressure_callback( callback_t callback )
+{
+    std::scoped_lock lock( _mutex );
+    return std::erase_if( _callbacks, [&]( auto& entry ){ return entry.first == callback; } ) > 0;
+}
+
+bool Manager::try_reserve( Account& account, size_t bytes ) noexcept
+{
+    const auto hard = account.hard.load( std::memory_order_relaxed );
+    auto       used = account.used.load( std::memory_order_relaxed );
+    do
+    {
+        if( bytes > hard || used > hard - bytes ) return false;
+    }
+    while( !account.used.compare_exchange_weak( used, used + bytes, std::memory_order_relaxed ) );
+    return true;
+}
+
+bool Manager::reserve( AllocatorAffinity affinity, size_t bytes )
+{
+    auto& account = _accounts[affinity];
+    if( !try_reserve( account, bytes ) )
+    {
+        // subsystems and the allocators get a chance to give memory back before growth is refused
+        raise( affinity, MEMORY_PRESSURE_HARD, account.used.load( std::memory_order_relaxed ) );
+
+        std::vector<Allocator*> allocators;
+        {
+            std::scoped_lock lock( _mutex );
+            allocators = _allocators;
+        }
+        for( auto allocator : allocators ) allocator->trim( affinity );
+
+        if( !try_reserve( account, bytes ) )
+        {
+            LOG_F( WARNING, "Manager::reserve( %hhu, %zu ) - hard budget of %zu bytes exceeded, %zu bytes in use.", affinity, bytes,
+                   account.hard.load( std::memory_order_relaxed ), account.used.load( std::memory_order_relaxed ) );
+            return false;
+        }
+    }
+
+    const auto used = account.used.load( std::memory_order_relaxed );
+    if( used > account.soft.load( std::memory_order_relaxed ) && account.pressure.load( std::memory_order_relaxed ) == MEMORY_PRESSURE_NONE )
+    {
+        raise( affinity, MEMORY_PRESSURE_SOFT, used );
+    }
+    return true;
+}
+
+void Manager::release( AllocatorAffinity affinity, size_t bytes ) noexcept
+{
+    auto& account = _accounts[affinity];
+    auto  used    = account.used.load( std::memory_order_relaxed );
+    while( !account.used.compare_exchange_weak( used, used - std::min( used, bytes ), std::memory_order_relaxed ) ) {}
+
+    if( used - std::min( used, bytes ) <= account.soft.load( std::memory_order_relaxed ) ) account.pressure.store( MEMORY_PRESSURE_NONE, std::memory_order_relaxed );
+}
+
+void Manager::raise( AllocatorAffinity affinity, MemoryPressure pressure, size_t used )
+{
+    _accounts[affinity].pressure.store( pressure, std::memory_order_relaxed );
+    if( raising ) return;
+
+    // callbacks run unlocked on a copy, so they may add or remove callbacks
+    Callbacks callbacks;
+    {
+        std::scoped_lock lock( _mutex );
+        callbacks = _callbacks;
+    }
+
+    LOG_F( INFO, "Manager - %s memory pressure on affinity %hhu, %zu bytes in use.", pressure == MEMORY_PRESSURE_HARD ? "hard" : "soft", affinity, used );
+
+    struct Raising { Raising() { raising = true; } ~Raising() { raising = false; } } scope;
+    for( auto& [id, callback] : callbacks ) ( *callback )( affinity, pressure, used );
 }
 
-} // namespace aer::mem
\ No newline at end of file
+} // namespace aer::mem
@@ -1,6 +1,15 @@
 #include <Base/memory/MemoryBlock.h>
+#include <Base/deferred_log.h>
+#include <Base/platform.h>
 #include <loguru.hpp>
 
+#if defined( AER_PLATFORM_WINDOWS )
+#   include <windows.h>
+#elif defined( AER_PLATFORM_LINUX )
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
 namespace aer::mem
 {
     
@@ -14,11 +23,17 @@ MemoryBlock::MemoryBlock( size_t in_size, AllocatorPolicy in_policy, MemoryTrack
         default:                                _memory = static_cast<uint8_t*>( operator new( in_size ) ); break;
     }
 
-    DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlock::MemoryBlock() - %zu bytes allocated.", in_size );
+    DEFERRED_DLOG_IF_F( INFO, memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlock::MemoryBlock() - %zu bytes allocated.", in_size );
 }
 
 MemoryBlock::~MemoryBlock()
 {
+#if defined( AER_PLATFORM_WINDOWS )
+    if( _locked ) VirtualUnlock( _memory, _slots.totalMemorySize() );
+#elif defined( AER_PLATFORM_LINUX )
+    if( _locked ) munlock( _memory, _slots.totalMemorySize() );
+#endif
+
     switch ( policy )
     {
         case ALLOCATOR_POLICY_NO_DELETE:                                    break;
@@ -27,12 +42,43 @@ MemoryBlock::~MemoryBlock()
         default:                                operator delete( _memory ); break;
     }
 
-    DLOG_IF_F( INFO, _slots.memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlock::MemoryBlock~() - %zu bytes deallocated.", _slots.totalMemorySize() );
+    DEFERRED_DLOG_IF_F( INFO, _slots.memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlock::MemoryBlock~() - %zu bytes deallocated.", _slots.totalMemorySize() );
+}
+
+static size_t page_size() noexcept
+{
+#if defined( AER_PLATFORM_WINDOWS )
+    SYSTEM_INFO info;
+    GetSystemInfo( &info );
+    return info.dwPageSize;
+#elif defined( AER_PLATFORM_LINUX )
+    return static_cast<size_t>( sysconf( _SC_PAGESIZE ) );
+#else
+    return 4096;
+#endif
+}
+
+bool MemoryBlock::prefault( bool lock )
+{
+    const auto size = _slots.totalMemorySize();
+    const auto page = page_size();
+    for( size_t offset = 0; offset < size; offset += page ) static_cast<volatile uint8_t*>( _memory )[offset] = 0;
+    if( !lock || _locked ) return true;
+
+#if defined( AER_PLATFORM_WINDOWS )
+    _locked = VirtualLock( _memory, size ) != 0;
+#elif defined( AER_PLATFORM_LINUX )
+    _locked = mlock( _memory, size ) == 0;
+#endif
+
+    LOG_IF_F( WARNING, !_locked, "Allocator::MemoryBlock::prefault() - %zu bytes could not be locked.", size );
+    return _locked;
 }
 
-void* MemoryBlock::allocate( size_t size )
+void* MemoryBlock::allocate( size_t size, const void* hint )
 {
-    auto offset = _slots.reserve( size );
+    auto offset = contains( hint ) ? _slots.reserve_near( size, static_cast<const uint8_t*>( hint ) - _memory, ALIGNMENT )
+                                   : _slots.reserve( size, ALIGNMENT );
     return offset.has_value() ? _memory + offset.value() : nullptr;
 }
 
@@ -45,7 +91,7 @@ bool MemoryBlock::deallocate( void* ptr, size_t size )
         {
             if( !_slots.release( offset, size ) )
             {
-                DLOG_IF_F( WARNING, _slots.memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlock::deallocate() - %zu bytes at offset %zu could not be released.", size, offset );
+                DEFERRED_DLOG_IF_F( WARNING, _slots.memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlock::deallocate() - %zu bytes at offset %zu could not be released.", size, offset );
             }
             return true;
         }
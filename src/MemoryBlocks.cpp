@@ -1,5 +1,7 @@
 #include <Base/memory/MemoryBlocks.h>
 #include <Base/memory/Allocator.h>
+#include <Base/deferred_log.h>
+#include <Base/Profiler.h>
 #include <loguru.hpp>
 
 namespace aer::mem
@@ -8,17 +10,30 @@ namespace aer::mem
 MemoryBlocks::MemoryBlocks( Allocator* in_parent, size_t in_blockSize )
     : parent( in_parent ), blockSize( in_blockSize )
 {
-    DLOG_IF_F( INFO, parent->memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlocks::MemoryBlocks( %p, %zu ).", parent, blockSize );
+    DEFERRED_DLOG_IF_F( INFO, parent->memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlocks::MemoryBlocks( %p, %zu ).", parent, blockSize );
 }
 
 MemoryBlocks::~MemoryBlocks()
 {
-    DLOG_IF_F( INFO, parent->memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlocks::~MemoryBlocks( %p, %zu ).", parent, blockSize );
+    DEFERRED_DLOG_IF_F( INFO, parent->memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlocks::~MemoryBlocks( %p, %zu ).", parent, blockSize );
 }
 
-void* MemoryBlocks::allocate( size_t size )
+void* MemoryBlocks::allocate( size_t size, const void* hint )
 {
-    if( _latestBlock )
+    AER_PROFILE_SCOPE( "mem::MemoryBlocks::allocate" );
+    std::shared_ptr<MemoryBlock> hintBlock;
+    if( hint && !_blocks.empty() )
+    {
+        auto itr = _blocks.upper_bound( const_cast<void*>( hint ) );
+        if( itr != _blocks.begin() && std::prev( itr )->second->contains( hint ) ) hintBlock = std::prev( itr )->second;
+        if( hintBlock )
+        {
+            auto ptr = hintBlock->allocate( size, hint );
+            if( ptr ) return ptr;
+        }
+    }
+
+    if( _latestBlock && _latestBlock != hintBlock )
     {
         auto ptr = _latestBlock->allocate( size );
         if( ptr ) return ptr;
@@ -27,22 +42,61 @@ void* MemoryBlocks::allocate( size_t size )
     for( auto itr = _blocks.rbegin(); itr != _blocks.rend(); ++itr )
     {
         auto& block = itr->second;
-        if( block != _latestBlock )
+        if( block != _latestBlock && block != hintBlock )
         {
             auto ptr = block->allocate( size );
             if( ptr ) return ptr;
         }
     }
 
-    auto block = std::make_shared<MemoryBlock>( std::max( size, blockSize ), parent->blockPolicy, parent->memoryTracking );
+    return nullptr;
+}
+
+void* MemoryBlocks::grow( size_t size )
+{
+    auto block = std::make_shared<MemoryBlock>( growth( size ), parent->blockPolicy, parent->memoryTracking );
     _latestBlock = block;
     auto ptr = block->allocate( size );
 
     _blocks[block->_memory] = std::move( block );
-    DLOG_IF_F( INFO, parent->memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlocks::allocate( %zu ) - allocating in new MemoryBlock.", size );
+    DEFERRED_DLOG_IF_F( INFO, parent->memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlocks::grow( %zu ) - allocating in new MemoryBlock.", size );
     return ptr;
 }
 
+bool MemoryBlocks::preallocate( bool lock )
+{
+    auto block  = std::make_shared<MemoryBlock>( blockSize, parent->blockPolicy, parent->memoryTracking );
+    auto locked = block->prefault( lock );
+    if( !_latestBlock ) _latestBlock = block;
+
+    _blocks[block->_memory] = std::move( block );
+    DEFERRED_DLOG_IF_F( INFO, parent->memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlocks::preallocate() - %zu bytes prefaulted.", blockSize );
+    return locked;
+}
+
+size_t MemoryBlocks::trim()
+{
+    size_t freed = 0;
+    for( auto itr = _blocks.begin(); itr != _blocks.end(); )
+    {
+        if( !itr->second->_slots.empty() ) { ++itr; continue; }
+
+        freed += itr->second->_slots.totalMemorySize();
+        if( _latestBlock == itr->second ) _latestBlock.reset();
+        itr = _blocks.erase( itr );
+    }
+
+    DEFERRED_DLOG_IF_F( INFO, parent->memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlocks::trim() - %zu bytes freed.", freed );
+    return freed;
+}
+
+size_t MemoryBlocks::totalMemorySize() const noexcept
+{
+    size_t size = 0;
+    for( auto& [memory, block] : _blocks ) size += block->_slots.totalMemorySize();
+    return size;
+}
+
 bool MemoryBlocks::deallocate( void* ptr, size_t size )
 {
     if( _blocks.empty() ) return false;
@@ -61,7 +115,7 @@ bool MemoryBlocks::deallocate( void* ptr, size_t size )
         if( block->deallocate( ptr, size ) ) return true;
     }
 
-    DLOG_IF_F( WARNING, parent->memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlocks::deallocate( %p, %zu ) - could not find pointer to deallocate.", ptr, size );
+    DEFERRED_DLOG_IF_F( WARNING, parent->memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS, "Allocator::MemoryBlocks::deallocate( %p, %zu ) - could not find pointer to deallocate.", ptr, size );
     return false;
 }
 
@@ -1,4 +1,5 @@
 #include <Base/memory/MemorySlots.h>
+#include <Base/deferred_log.h>
 #include <loguru.hpp>
 
 namespace aer::mem
@@ -13,7 +14,7 @@ MemorySlots::MemorySlots( size_t availableMemorySize, MemoryTracking tracking )
 std::optional<offset_t> MemorySlots::reserve( size_t size, size_t alignment )
 {
     const auto report = memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS;
-    DLOG_IF_F( INFO, report, "MemorySlots::reserve( %zu, %zu )", size, alignment );
+    DEFERRED_DLOG_IF_F( INFO, report, "MemorySlots::reserve( %zu, %zu )", size, alignment );
 
     if( full() ) return std::nullopt;
     
@@ -29,35 +30,79 @@ std::optional<offset_t> MemorySlots::reserve( size_t size, size_t alignment )
         // slot is not big enough, advance to next slot
         if( alignedEnd > slotEnd ) { ++itr; continue; }
 
-        // remove the slot that will be used
-        remove( slotStart, slotSize );
+        DEFERRED_DLOG_IF_F( INFO, report, "MemorySlots::reserve() - %zu bytes reserved at offset %zu.", size, alignedStart );
+        return carve( slotStart, slotSize, alignedStart, size );
+    }
 
-        // create slots for either side of the newly reserved memory 
-        if( slotStart < alignedStart ) insert( slotStart, alignedStart - slotStart );
-        if( alignedEnd < slotEnd )     insert( alignedEnd, slotEnd - alignedEnd );
+    DEFERRED_DLOG_IF_F( INFO, report, "MemorySlots::reserve() - %zu bytes requested, but no slot was big enough.", size );
+    return std::nullopt;
+}
 
-        // record and return the reserved slot
-        _reservedMemory.emplace( alignedStart, size );
-        return alignedStart;
-    
-        DLOG_IF_F( INFO, report, "MemorySlots::reserve() - %zu bytes reserved at offset %zu.", size, alignedStart );
+std::optional<offset_t> MemorySlots::reserve_near( size_t size, offset_t hint, size_t alignment )
+{
+    const auto report = memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS;
+    DEFERRED_DLOG_IF_F( INFO, report, "MemorySlots::reserve_near( %zu, %zu, %zu )", size, hint, alignment );
+
+    if( full() ) return std::nullopt;
+
+    // free slots are ordered by offset, walk outwards from hint and take the first one that fits;
+    // memory after hint is used from its start, memory before hint from its end
+    auto next = _offsetSizes.upper_bound( hint );
+    auto prev = next;
+    for( size_t i = 0; i < NEAR_SEARCH_LIMIT; ++i )
+    {
+        if( next != _offsetSizes.end() )
+        {
+            auto [slotStart, slotSize] = *next++;
+            offset_t alignedStart = ( ( slotStart + alignment - 1 ) / alignment ) * alignment;
+            if( alignedStart + size <= slotStart + slotSize ) return carve( slotStart, slotSize, alignedStart, size );
+        }
+
+        if( prev != _offsetSizes.begin() )
+        {
+            auto [slotStart, slotSize] = *--prev;
+            offset_t slotEnd = slotStart + slotSize;
+            if( slotEnd >= size )
+            {
+                offset_t alignedStart = ( ( slotEnd - size ) / alignment ) * alignment;
+                if( alignedStart >= slotStart ) return carve( slotStart, slotSize, alignedStart, size );
+            }
+        }
+        else if( next == _offsetSizes.end() ) break;
     }
 
-    DLOG_IF_F( INFO, report, "MemorySlots::reserve() - %zu bytes requested, but no slot was big enough.", size );
-    return std::nullopt;
+    DEFERRED_DLOG_IF_F( INFO, report, "MemorySlots::reserve_near() - no slot near offset %zu, falling back to reserve().", hint );
+    return reserve( size, alignment );
+}
+
+offset_t MemorySlots::carve( offset_t slotStart, size_t slotSize, offset_t alignedStart, size_t size )
+{
+    offset_t slotEnd    = slotStart + slotSize;
+    offset_t alignedEnd = alignedStart + size;
+
+    // remove the slot that will be used
+    remove( slotStart, slotSize );
+
+    // create slots for either side of the newly reserved memory 
+    if( slotStart < alignedStart ) insert( slotStart, alignedStart - slotStart );
+    if( alignedEnd < slotEnd )     insert( alignedEnd, slotEnd - alignedEnd );
+
+    // record and return the reserved slot
+    _reservedMemory.emplace( alignedStart, size );
+    return alignedStart;
 }
 
 bool MemorySlots::release( offset_t offset, size_t size )
 {
     const auto report = memoryTracking & MEMORY_TRACKING_REPORT_ACTIONS;
-    DLOG_IF_F( INFO, report, "MemorySlots::release( %zu )", offset );
+    DEFERRED_DLOG_IF_F( INFO, report, "MemorySlots::release( %zu )", offset );
 
     auto itr = _reservedMemory.find( offset );
     if( itr == _reservedMemory.end() ) return false; // entry not found
 
     if( size != itr->second )
     {
-        DLOG_IF_F( INFO, report, "MemorySlots::release() - %zu bytes requested, but %zu bytes were reserved.", size, itr->second );
+        DEFERRED_DLOG_IF_F( INFO, report, "MemorySlots::release() - %zu bytes requested, but %zu bytes were reserved.", size, itr->second );
         size = itr->second;
     }
 
@@ -72,8 +117,11 @@ bool MemorySlots::release( offset_t offset, size_t size )
     auto slotStart = offset;
     auto slotEnd   = offset + size;
     
-    // merge with next slot if adjacent
+    // find both neighbours before merging, removing a slot invalidates its iterator
     auto nextItr = _offsetSizes.upper_bound( offset );
+    auto prevItr = nextItr != _offsetSizes.begin() ? std::prev( nextItr ) : _offsetSizes.end();
+
+    // merge with next slot if adjacent
     if( nextItr != _offsetSizes.end() && nextItr->first == slotEnd )
     {
         slotEnd = nextItr->first + nextItr->second;
@@ -81,9 +129,7 @@ bool MemorySlots::release( offset_t offset, size_t size )
     }
     
     // merge with previous slot if adjacent
-    auto prevItr = nextItr != _offsetSizes.end() ? std::prev( nextItr ) : _offsetSizes.end();
-    auto prevSlotEnd = prevItr->first + prevItr->second;
-    if( prevSlotEnd == slotStart )
+    if( prevItr != _offsetSizes.end() && prevItr->first + prevItr->second == slotStart )
     {
         slotStart = prevItr->first;
         remove( prevItr->first, prevItr->second );
@@ -0,0 +1,66 @@
+#include <Base/Mutex.h>
+#include <Base/type_id.h>
+
+namespace aer
+{
+
+std::array<LockStats::Slot, LockStats::MAX_LOCKS> LockStats::_slots;
+
+// open addressing on the hashed name, slots are claimed once and never released
+LockStats::Slot* LockStats::find( const char* name ) noexcept
+{
+    if constexpr( !AER_LOCK_STATS ) return nullptr;
+    if( !name ) return nullptr;
+
+    const auto key = std::max<uint64_t>( detail::fnv1a( name ), 1 );
+    for( size_t probe = 0; probe < MAX_LOCKS; ++probe )
+    {
+        auto& slot     = _slots[( key + probe ) % MAX_LOCKS];
+        auto  expected = slot.key.load( std::memory_order_acquire );
+        if( expected == key ) return &slot;
+        if( expected == 0 )
+        {
+            if( slot.key.compare_exchange_strong( expected, key, std::memory_order_acq_rel ) )
+            {
+                slot.name.store( name, std::memory_order_release );
+                return &slot;
+            }
+            if( expected == key ) return &slot;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<LockInfo> LockStats::snapshot()
+{
+    std::vector<LockInfo> snapshot;
+    for( auto& slot : _slots )
+    {
+        if( slot.key.load( std::memory_order_acquire ) == 0 ) continue;
+
+        LockInfo info;
+        info.name         = slot.name.load( std::memory_order_acquire );
+        info.acquisitions = slot.acquisitions.load( std::memory_order_relaxed );
+        info.contended    = slot.contended.load( std::memory_order_relaxed );
+        info.parked       = slot.parked.load( std::memory_order_relaxed );
+        for( size_t i = 0; i < LatencyHistogram::BUCKETS; ++i )
+        {
+            info.waitTime.counts[i] = slot.waitTime[i].load( std::memory_order_relaxed );
+            info.holdTime.counts[i] = slot.holdTime[i].load( std::memory_order_relaxed );
+        }
+        snapshot.push_back( info );
+    }
+    return snapshot;
+}
+
+void LockStats::reset() noexcept
+{
+    for( auto& slot : _slots )
+    {
+        for( auto counter : { &slot.acquisitions, &slot.contended, &slot.parked } ) counter->store( 0, std::memory_order_relaxed );
+        for( auto& count : slot.waitTime ) count.store( 0, std::memory_order_relaxed );
+        for( auto& count : slot.holdTime ) count.store( 0, std::memory_order_relaxed );
+    }
+}
+
+} // namespace aer
@@ -0,0 +1,110 @@
+#include <Base/Profiler.h>
+#include <loguru.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <new>
+
+namespace aer
+{
+
+utils::PerThread<std::atomic<Profiler::Ring*>>& Profiler::rings()
+{
+    // rings are never freed, a thread may still be recording while the process shuts down
+    static auto rings = new utils::PerThread<std::atomic<Ring*>>();
+    return *rings;
+}
+
+void Profiler::record( const char* name, uint64_t begin, uint64_t end ) noexcept
+{
+    auto& slot = rings().local();
+    auto  ring = slot.load( std::memory_order_relaxed );
+    if( !ring ) [[unlikely]]
+    {
+        ring = new( std::nothrow ) Ring();
+        if( !ring ) return;
+        slot.store( ring, std::memory_order_release );
+    }
+
+    auto  head  = ring->head.load( std::memory_order_relaxed );
+    auto& entry = ring->entries[head % RING_CAPACITY];
+
+    // a reader that sees any of the stores below also sees head at least at this value, see write_chrome_trace()
+    std::atomic_thread_fence( std::memory_order_release );
+    entry.name.store(  name,  std::memory_order_relaxed );
+    entry.begin.store( begin, std::memory_order_relaxed );
+    entry.end.store(   end,   std::memory_order_relaxed );
+    ring->head.store( head + 1, std::memory_order_release );
+}
+
+// trace events count in microseconds, nanoseconds are kept as three decimals
+static void write_microseconds( std::ostream& stream, uint64_t nanoseconds )
+{
+    stream << nanoseconds / 1000 << '.' << std::setw( 3 ) << std::setfill( '0' ) << nanoseconds % 1000 << std::setfill( ' ' );
+}
+
+static void write_escaped( std::ostream& stream, const char* str )
+{
+    for( ; str && *str; ++str )
+    {
+        if( *str == '"' || *str == '\\' ) stream << '\\';
+        stream << *str;
+    }
+}
+
+void Profiler::write_chrome_trace( std::ostream& stream )
+{
+    stream << "{\"traceEvents\":[";
+
+    bool first = true;
+    rings().for_each( [&]( utils::thread_index_t thread, std::atomic<Ring*>& slot )
+    {
+        auto ring = slot.load( std::memory_order_acquire );
+        if( !ring ) return;
+
+        // the oldest slot is the one the next record() overwrites, it is never read
+        auto head  = ring->head.load( std::memory_order_acquire );
+        auto begin = head >= RING_CAPACITY ? head - RING_CAPACITY + 1 : 0;
+        for( auto i = begin; i < head; ++i )
+        {
+            auto& entry = ring->entries[i % RING_CAPACITY];
+            auto  event = ProfileEvent{ entry.name.load( std::memory_order_relaxed ), entry.begin.load( std::memory_order_relaxed ), entry.end.load( std::memory_order_relaxed ) };
+
+            // the owner may have lapped us while copying, those entries belong to newer zones; the fence pairs
+            // with the one in record() and keeps the entry loads ahead of the head re-check
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if( ring->head.load( std::memory_order_relaxed ) >= i + RING_CAPACITY ) continue;
+            if( !event.name || event.end < event.begin ) continue;
+
+            stream << ( first ? "\n" : ",\n" ) << "{\"name\":\"";
+            write_escaped( stream, event.name );
+            stream << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread << ",\"ts\":";
+            write_microseconds( stream, event.begin );
+            stream << ",\"dur\":";
+            write_microseconds( stream, event.end - event.begin );
+            stream << '}';
+            first = false;
+        }
+    } );
+
+    stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+bool Profiler::save_chrome_trace( const std::filesystem::path& path )
+{
+    std::ofstream file( path, std::ios::trunc );
+    write_chrome_trace( file );
+
+    LOG_IF_F( ERROR, !file, "Profiler::save_chrome_trace( %s ) - could not write file.", path.string().c_str() );
+    return static_cast<bool>( file );
+}
+
+void Profiler::clear() noexcept
+{
+    rings().for_each( []( utils::thread_index_t, std::atomic<Ring*>& slot )
+    {
+        if( auto ring = slot.load( std::memory_order_acquire ) ) ring->head.store( 0, std::memory_order_release );
+    } );
+}
+
+} // namespace aer
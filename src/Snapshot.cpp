@@ -0,0 +1,216 @@
+#include <Base/nodes/Snapshot.h>
+#include <Base/TypeRegistry.h>
+#include <Base/platform.h>
+#include <loguru.hpp>
+
+#include <fstream>
+
+#ifdef AER_PLATFORM_WINDOWS
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace aer
+{
+
+std::unordered_map<type_id_t, Snapshot::Factory>& Snapshot::factories()
+{
+    static std::unordered_map<type_id_t, Factory> factories
+    {
+        { aer::type_id<Node>(),  []{ return Node::create(); } },
+        { aer::type_id<Group>(), []{ return ref_ptr<Node>( Group::create( 0 ).get() ); } }
+    };
+    return factories;
+}
+
+bool Snapshot::write( const ref_ptr<Node>& root, const std::filesystem::path& path )
+{
+    if( !root ) return false;
+
+    // assign indices breadth first so that siblings are adjacent in the node table
+    std::unordered_map<const Node*, index_t> indices;
+    std::vector<const Node*>                 order;
+    auto index_of = [&]( const Node* node ) -> index_t
+    {
+        if( !node ) return npos;
+        auto [itr, inserted] = indices.try_emplace( node, static_cast<index_t>( order.size() ) );
+        if( inserted ) order.push_back( node );
+        return itr->second;
+    };
+
+    std::vector<SnapshotNode> records;
+    std::vector<index_t>      children;
+
+    index_of( root.get() );
+    for( size_t i = 0; i < order.size(); ++i )
+    {
+        if( order.size() >= npos )
+        {
+            LOG_F( ERROR, "Snapshot::write( %s ) - graph exceeds %u nodes.", path.string().c_str(), npos );
+            return false;
+        }
+
+        auto node   = order[i];
+        auto record = SnapshotNode{ node->type_id(), static_cast<index_t>( children.size() ), 0 };
+        if( auto group = aer::cast<const Group>( node ) )
+        {
+            auto list = group->children();
+            record.childCount = static_cast<index_t>( list->size() );
+            for( auto& child : *list ) children.push_back( index_of( child.get() ) );
+        }
+        records.push_back( record );
+    }
+
+    SnapshotHeader header;
+    header.root           = 0;
+    header.nodeCount      = static_cast<uint32_t>( records.size() );
+    header.nodesOffset    = sizeof( SnapshotHeader );
+    header.childrenOffset = header.nodesOffset + records.size() * sizeof( SnapshotNode );
+    header.childrenCount  = children.size();
+
+    std::ofstream file( path, std::ios::binary | std::ios::trunc );
+    file.write( reinterpret_cast<const char*>( &header ),         sizeof( header ) );
+    file.write( reinterpret_cast<const char*>( records.data() ),  records.size()  * sizeof( SnapshotNode ) );
+    file.write( reinterpret_cast<const char*>( children.data() ), children.size() * sizeof( index_t ) );
+
+    LOG_IF_F( ERROR, !file, "Snapshot::write( %s ) - could not write file.", path.string().c_str() );
+    return static_cast<bool>( file );
+}
+
+ref_ptr<Snapshot> Snapshot::map( const std::filesystem::path& path )
+{
+    const uint8_t* data = nullptr;
+    size_t         size = 0;
+
+#ifdef AER_PLATFORM_WINDOWS
+    auto file = CreateFileW( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if( file != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER fileSize{};
+        if( GetFileSizeEx( file, &fileSize ) && fileSize.QuadPart > 0 )
+        {
+            if( auto mapping = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr ) )
+            {
+                data = static_cast<const uint8_t*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+                size = static_cast<size_t>( fileSize.QuadPart );
+                CloseHandle( mapping );
+            }
+        }
+        CloseHandle( file );
+    }
+#else
+    auto file = ::open( path.c_str(), O_RDONLY );
+    if( file >= 0 )
+    {
+        struct stat info{};
+        if( ::fstat( file, &info ) == 0 && info.st_size > 0 )
+        {
+            auto mapped = ::mmap( nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0 );
+            if( mapped != MAP_FAILED )
+            {
+                data = static_cast<const uint8_t*>( mapped );
+                size = static_cast<size_t>( info.st_size );
+            }
+        }
+        ::close( file );
+    }
+#endif
+
+    if( !data )
+    {
+        LOG_F( ERROR, "Snapshot::map( %s ) - could not map file.", path.string().c_str() );
+        return {};
+    }
+
+    // the snapshot owns the mapping from here, so invalid images are unmapped by its destructor
+    auto snapshot = Snapshot::create( data, size );
+    auto& header  = snapshot->header();
+
+    // the header fields are untrusted, every bound is checked against the space left so nothing can wrap
+    const bool valid = size >= sizeof( SnapshotHeader )
+                    && header.magic == SnapshotHeader::MAGIC
+                    && header.version == SnapshotHeader::VERSION
+                    && header.nodesOffset <= size && header.nodesOffset % alignof( SnapshotNode ) == 0
+                    && header.nodeCount <= ( size - header.nodesOffset ) / sizeof( SnapshotNode )
+                    && header.childrenOffset <= size && header.childrenOffset % alignof( index_t ) == 0
+                    && header.childrenCount <= ( size - header.childrenOffset ) / sizeof( index_t )
+                    && ( header.nodeCount == 0 || header.root < header.nodeCount );
+    if( !valid )
+    {
+        LOG_F( ERROR, "Snapshot::map( %s ) - not a valid snapshot image.", path.string().c_str() );
+        return {};
+    }
+    return snapshot;
+}
+
+Snapshot::~Snapshot()
+{
+#ifdef AER_PLATFORM_WINDOWS
+    UnmapViewOfFile( _data );
+#else
+    ::munmap( const_cast<uint8_t*>( _data ), _size );
+#endif
+}
+
+ref_ptr<Node> Snapshot::materialize( index_t index )
+{
+    if( index >= header().nodeCount ) return {};
+
+    if( _materialized.empty() ) _materialized.resize( header().nodeCount );
+    if( _materialized[index] )  return _materialized[index];
+
+    auto& registry = factories();
+
+    // explicit stack, every node not built by an earlier call is created first and the groups are filled
+    // once all of them exist, so deep chains, shared nodes and cycles need no recursion
+    std::vector<index_t> stack{ index };
+    std::vector<index_t> created;
+    while( !stack.empty() )
+    {
+        auto current = stack.back();
+        stack.pop_back();
+        if( _materialized[current] ) continue;
+
+        auto& record = nodes()[current];
+        if( record.firstChild + uint64_t( record.childCount ) > header().childrenCount )
+        {
+            LOG_F( ERROR, "Snapshot::materialize( %u ) - child range is out of bounds.", current );
+            continue;
+        }
+
+        auto factory = registry.find( record.type );
+        LOG_IF_F( WARNING, factory == registry.end(), "Snapshot::materialize( %u ) - no factory for %s, using Node.", current, TypeRegistry::instance().name( record.type ) );
+
+        _materialized[current] = factory != registry.end() ? factory->second() : Node::create();
+        created.push_back( current );
+
+        for( auto child : children( current ) ) if( child < header().nodeCount && !_materialized[child] ) stack.push_back( child );
+    }
+
+    // children that failed to build or lie outside the node table are left null
+    for( auto current : created )
+    {
+        auto& record = nodes()[current];
+        if( record.childCount == 0 ) continue;
+
+        auto group = aer::cast<Group>( _materialized[current].get() );
+        if( !group )
+        {
+            LOG_F( WARNING, "Snapshot::materialize( %u ) - %s is not a Group, %u children dropped.", current, TypeRegistry::instance().name( record.type ), record.childCount );
+            continue;
+        }
+
+        std::vector<ref_ptr<Node>> nodes;
+        nodes.reserve( record.childCount );
+        for( auto child : children( current ) ) nodes.push_back( child < header().nodeCount ? _materialized[child] : ref_ptr<Node>() );
+        group->assign( std::move( nodes ) );
+    }
+
+    return _materialized[index];
+}
+
+} // namespace aer
@@ -0,0 +1,41 @@
+#include <Base/TypeRegistry.h>
+#include <loguru.hpp>
+
+#include <mutex>
+
+namespace aer
+{
+
+type_id_t TypeRegistry::add( const TypeInfo& info )
+{
+    std::unique_lock lock( _mutex );
+    auto [itr, inserted] = _types.try_emplace( info.id, info );
+
+    LOG_IF_F( ERROR, !inserted && itr->second.name != info.name, "TypeRegistry::add() - type id %016llx collision between %s and %s.",
+              static_cast<unsigned long long>( info.id ), itr->second.name.data(), info.name.data() );
+    return info.id;
+}
+
+const TypeInfo* TypeRegistry::find( type_id_t id ) const
+{
+    std::shared_lock lock( _mutex );
+    auto itr = _types.find( id );
+    return itr != _types.end() ? &itr->second : nullptr;
+}
+
+const char* TypeRegistry::name( type_id_t id ) const
+{
+    auto info = find( id );
+    return info ? info->name.data() : "<unregistered type>";
+}
+
+std::vector<TypeInfo> TypeRegistry::types() const
+{
+    std::shared_lock lock( _mutex );
+    std::vector<TypeInfo> types;
+    types.reserve( _types.size() );
+    for( auto& [id, info] : _types ) types.push_back( info );
+    return types;
+}
+
+} // namespace aer
@@ -0,0 +1,131 @@
+#include <Base/deferred_log.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace aer
+{
+
+// single producer ring, drained by whichever thread holds the consumer lock
+struct DeferredLog::Ring
+{
+    std::atomic<uint64_t>               head = 0;
+    std::atomic<uint64_t>               tail = 0;
+    std::array<Record, RING_CAPACITY>   records;
+};
+
+struct DeferredLog::Backend
+{
+    utils::PerThread<std::atomic<Ring*>>    rings;
+    std::atomic_bool                        stopped = false;
+    std::mutex                              consumerMutex;
+    std::mutex                              sleepMutex;
+    std::condition_variable                 wake;
+    bool                                    stopping = false;
+    std::thread                             worker;
+
+    Backend() : worker( [this]{ run(); } ) {}
+
+    void stop()
+    {
+        {
+            std::scoped_lock lock( sleepMutex );
+            if( stopping ) return;
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+
+        stopped.store( true, std::memory_order_release );
+        drain();
+    }
+
+    void run()
+    {
+        loguru::set_thread_name( "aer deferred log" );
+        std::unique_lock lock( sleepMutex );
+        while( !stopping )
+        {
+            wake.wait_for( lock, FLUSH_INTERVAL );
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+    void drain()
+    {
+        std::scoped_lock lock( consumerMutex );
+        rings.for_each( [&]( utils::thread_index_t, std::atomic<Ring*>& slot )
+        {
+            auto ring = slot.load( std::memory_order_acquire );
+            if( !ring ) return;
+
+            auto tail = ring->tail.load( std::memory_order_relaxed );
+            auto head = ring->head.load( std::memory_order_acquire );
+            for( ; tail < head; ++tail ) write( ring->records[tail % RING_CAPACITY] );
+            ring->tail.store( tail, std::memory_order_release );
+        } );
+
+        if( auto dropped = _dropped.exchange( 0, std::memory_order_relaxed ) )
+        {
+            LOG_F( WARNING, "DeferredLog - %zu messages dropped, the buffers were full.", dropped );
+        }
+    }
+};
+
+DeferredLog::Backend* DeferredLog::backend()
+{
+    // never destroyed, messages from later static destructors are written synchronously instead
+    // the registry is created first so it outlives the worker's last drain
+    static auto backend = ( utils::ThreadRegistry::instance(), new Backend() );
+    static struct Shutdown { ~Shutdown() { backend->stop(); } } shutdown;
+    return backend;
+}
+
+void DeferredLog::write( const Record& record ) noexcept
+{
+    char message[MESSAGE_SIZE];
+    record.formatter( message, sizeof( message ), record.format, record.arguments );
+    loguru::log( record.verbosity, record.file, record.line, "[thread %u] %s", record.thread, message );
+}
+
+void DeferredLog::push( Record& record ) noexcept
+{
+    auto backend = DeferredLog::backend();
+    record.thread = utils::thread_id();
+    if( backend->stopped.load( std::memory_order_acquire ) ) return write( record );
+
+    auto& slot = backend->rings.local();
+    auto  ring = slot.load( std::memory_order_relaxed );
+    if( !ring ) [[unlikely]]
+    {
+        ring = new( std::nothrow ) Ring();
+        if( !ring ) { _dropped.fetch_add( 1, std::memory_order_relaxed ); return; }
+        slot.store( ring, std::memory_order_release );
+    }
+
+    auto head = ring->head.load( std::memory_order_relaxed );
+    if( head - ring->tail.load( std::memory_order_acquire ) >= RING_CAPACITY )
+    {
+        _dropped.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+
+    ring->records[head % RING_CAPACITY] = record;
+    ring->head.store( head + 1, std::memory_order_release );
+}
+
+void DeferredLog::flush()
+{
+    backend()->drain();
+}
+
+void DeferredLog::shutdown()
+{
+    backend()->stop();
+}
+
+} // namespace aer
@@ -0,0 +1,64 @@
+#include <Base/thread_utils.h>
+#include <loguru.hpp>
+
+namespace aer::utils
+{
+
+size_t num_threads()
+{
+    static size_t num_threads = [] -> size_t
+    {
+        if( const auto num = std::getenv("NUM_THREADS") ) return std::stoi( num ) + 1;
+        else return std::thread::hardware_concurrency() + 1;
+    }();
+    return num_threads;
+}
+
+thread_index_t ThreadRegistry::acquire()
+{
+    _active.fetch_add( 1, std::memory_order_relaxed );
+
+    auto head = _free.load( std::memory_order_acquire );
+    while( static_cast<thread_index_t>( head ) != 0 )
+    {
+        auto id   = static_cast<thread_index_t>( head ) - 1;
+        auto next = uint64_t( _links[id].load( std::memory_order_relaxed ) );
+        if( _free.compare_exchange_weak( head, ( ( ( head >> 32 ) + 1 ) << 32 ) | next, std::memory_order_acquire, std::memory_order_acquire ) ) return id;
+    }
+
+    auto id = _minted.fetch_add( 1, std::memory_order_acq_rel );
+    if( id >= MAX_THREADS ) ABORT_F( "ThreadRegistry::acquire() - more than %u threads alive.", MAX_THREADS );
+    return id;
+}
+
+void ThreadRegistry::release( thread_index_t id ) noexcept
+{
+    auto head = _free.load( std::memory_order_relaxed );
+    do
+    {
+        _links[id].store( static_cast<thread_index_t>( head ), std::memory_order_relaxed );
+    }
+    while( !_free.compare_exchange_weak( head, ( ( ( head >> 32 ) + 1 ) << 32 ) | ( id + 1 ), std::memory_order_release, std::memory_order_relaxed ) );
+
+    _active.fetch_sub( 1, std::memory_order_relaxed );
+}
+
+namespace
+{
+
+struct ThreadRegistration
+{
+    const thread_index_t id = ThreadRegistry::instance().acquire();
+    // threads outliving the registry, e.g. workers joined by a later singleton, have nothing to give back
+    ~ThreadRegistration() { if( auto registry = ThreadRegistry::existing() ) registry->release( id ); }
+};
+
+} // namespace
+
+thread_index_t thread_id() noexcept
+{
+    thread_local ThreadRegistration registration;
+    return registration.id;
+}
+
+} // namespace aer::utils
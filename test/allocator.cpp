@@ -0,0 +1,160 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/memory/Allocator.h>
+
+#include <array>
+#include <memory>
+#include <new>
+#include <vector>
+
+using namespace aer;
+
+namespace
+{
+
+// allocates from a private allocator, so switching it to deterministic mode leaves the process one alone
+struct Probe
+{
+    static inline mem::Allocator* allocator   = nullptr;
+    static inline size_t          constructed = 0;
+
+    static void* operator new( size_t size )               { return allocator->allocate( size ); }
+    static void  operator delete( void* ptr, size_t size ) { allocator->deallocate( ptr, size ); }
+
+    Probe() { ++constructed; }
+
+    std::array<uint8_t, 64 * 1024> payload;
+};
+
+} // namespace
+
+TEST_CASE( "Deterministic mode fails allocations instead of growing", "[allocator]" )
+{
+    mem::Allocator allocator;
+    allocator.policy = mem::ALLOCATOR_POLICY_AER_ALLOC_DEALLOC;
+
+    mem::DeterministicConfig config;
+    config.blocks[mem::ALLOCATOR_AFFINITY_OBJECTS] = 1;
+    REQUIRE( allocator.make_deterministic( config ) );
+    REQUIRE_FALSE( allocator.growth_allowed() );
+
+    Probe::allocator   = &allocator;
+    Probe::constructed = 0;
+
+    size_t failures = 0;
+    allocator.onGrowthFailure = [&]( size_t size, mem::AllocatorAffinity affinity )
+    {
+        CHECK( size == sizeof( Probe ) );
+        CHECK( affinity == mem::ALLOCATOR_AFFINITY_OBJECTS );
+        ++failures;
+    };
+
+    // fill the one preallocated block, far fewer probes fit than the limit
+    std::vector<std::unique_ptr<Probe>> probes;
+    const auto backing = allocator.backing_size( mem::ALLOCATOR_AFFINITY_OBJECTS );
+    while( failures == 0 && probes.size() < 64 )
+    {
+        try                         { probes.emplace_back( new Probe ); }
+        catch( std::bad_alloc& )    {}
+    }
+
+    CHECK( failures == 1 );
+    CHECK( Probe::constructed == probes.size() );
+    CHECK( allocator.backing_size( mem::ALLOCATOR_AFFINITY_OBJECTS ) == backing );
+
+    SECTION( "a hook that frees nothing leaves the allocation failed" )
+    {
+        CHECK_THROWS_AS( new Probe, std::bad_alloc );
+        CHECK( failures == 2 );
+        CHECK( Probe::constructed == probes.size() );
+    }
+
+    SECTION( "a hook that frees memory lets the retry succeed" )
+    {
+        allocator.onGrowthFailure = [&]( size_t, mem::AllocatorAffinity ) { ++failures; probes.pop_back(); };
+        const auto live = probes.size();
+
+        probes.emplace_back( new Probe );
+        CHECK( failures == 2 );
+        CHECK( probes.size() == live );
+        CHECK( Probe::constructed == live + 1 );
+    }
+
+    probes.clear();
+}
+
+TEST_CASE( "Placement hints are ignored by the default policy and honoured by blocks", "[allocator]" )
+{
+    constexpr size_t SIZE = 64;
+
+    mem::Allocator allocator;
+    REQUIRE( allocator.policy == mem::ALLOCATOR_POLICY_DEFAULT );
+
+    SECTION( "default policy" )
+    {
+        // the hint is accepted but the memory comes from operator new, no block backs it
+        auto first  = allocator.allocate( SIZE, mem::ALLOCATOR_AFFINITY_NODES );
+        auto second = allocator.allocate( SIZE, mem::ALLOCATOR_AFFINITY_NODES, first );
+        REQUIRE( first );
+        REQUIRE( second );
+        CHECK( allocator.backing_size( mem::ALLOCATOR_AFFINITY_NODES ) == 0 );
+        CHECK( allocator.deallocate( second, SIZE ) );
+        CHECK( allocator.deallocate( first,  SIZE ) );
+
+        // arenas take precedence over the policy, so they still keep allocations together
+        auto arena = allocator.create_arena( 4 * SIZE );
+        REQUIRE( arena );
+        {
+            mem::ArenaScope scope( arena );
+            auto inside = static_cast<uint8_t*>( allocator.allocate( SIZE, mem::ALLOCATOR_AFFINITY_NODES ) );
+            auto next   = static_cast<uint8_t*>( allocator.allocate( SIZE, mem::ALLOCATOR_AFFINITY_NODES ) );
+            CHECK( next == inside + SIZE );
+            CHECK( arena->live() == 2 );
+            allocator.deallocate( inside, SIZE );
+            allocator.deallocate( next,   SIZE );
+        }
+        allocator.release_arena( arena );
+    }
+
+    SECTION( "block policy" )
+    {
+        allocator.policy = mem::ALLOCATOR_POLICY_AER_ALLOC_DEALLOC;
+
+        // a freed slot right behind the hint is taken instead of the next free one
+        std::vector<void*> ptrs;
+        for( size_t i = 0; i < 8; ++i ) ptrs.push_back( allocator.allocate( SIZE, mem::ALLOCATOR_AFFINITY_NODES ) );
+        CHECK( allocator.backing_size( mem::ALLOCATOR_AFFINITY_NODES ) > 0 );
+
+        allocator.deallocate( ptrs[1], SIZE );
+        allocator.deallocate( ptrs[6], SIZE );
+        ptrs[6] = allocator.allocate( SIZE, mem::ALLOCATOR_AFFINITY_NODES, ptrs[5] );
+        ptrs[1] = allocator.allocate( SIZE, mem::ALLOCATOR_AFFINITY_NODES, ptrs[0] );
+        CHECK( static_cast<uint8_t*>( ptrs[6] ) == static_cast<uint8_t*>( ptrs[5] ) + SIZE );
+        CHECK( static_cast<uint8_t*>( ptrs[1] ) == static_cast<uint8_t*>( ptrs[0] ) + SIZE );
+
+        for( auto ptr : ptrs ) allocator.deallocate( ptr, SIZE );
+    }
+}
+
+TEST_CASE( "Arenas go back with the allocator that created them", "[allocator]" )
+{
+    constexpr size_t CAPACITY = 1024;
+
+    auto allocator = std::make_unique<mem::Allocator>();
+    auto kept      = allocator->create_arena( CAPACITY );
+    auto released  = allocator->create_arena( CAPACITY );
+    REQUIRE( kept );
+    REQUIRE( released );
+
+    {
+        mem::ArenaScope scope( released );
+        CHECK( allocator->allocate( 64, mem::ALLOCATOR_AFFINITY_NODES ) );
+    }
+    allocator->release_arena( released );
+    CHECK( released->live() == 1 );
+    CHECK( released->used() == 64 );
+    CHECK( allocator->backing_size( mem::ALLOCATOR_AFFINITY_NODES ) == 2 * CAPACITY );
+
+    // neither arena was freed by release_arena(), a leak checking build reports them unless the destructor does
+    allocator.reset();
+}
@@ -0,0 +1,273 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/Base.h>
+#include <Base/EventListener.h>
+#include <Base/histogram.h>
+#include <Base/memory/spy_ptr.h>
+#include <Base/thread_utils.h>
+
+#include <barrier>
+#include <cstdio>
+#include <deque>
+#include <thread>
+#include <tuple>
+
+using namespace aer;
+
+namespace
+{
+
+// counts destructions so leaks and double frees show up as a mismatch
+struct Tracked : public inherit<Tracked, Object>
+{
+    static inline std::atomic<int64_t> alive = 0;
+
+    explicit Tracked( uint64_t in_value = 0 ) : value( in_value ) { alive.fetch_add( 1, std::memory_order_relaxed ); }
+            ~Tracked() { alive.fetch_sub( 1, std::memory_order_relaxed ); }
+
+    const uint64_t value;
+};
+
+struct Ping : public inherit<Ping, Event>
+{
+    Ping( uint32_t in_producer, uint32_t in_sequence ) : producer( in_producer ), sequence( in_sequence ) {}
+
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+struct Sink : public IEventListener<Sink>
+{
+    explicit Sink( size_t capacity ) : IEventListener( capacity ) { overflowPolicy = EVENT_OVERFLOW_BLOCK; }
+};
+
+// Catch2 assertions are not thread safe, workers count their failures and the test checks the total
+struct Result
+{
+    size_t              threads    = 0;
+    uint64_t            operations = 0;
+    uint64_t            elapsed    = 0;     // nanoseconds of the slowest thread
+    LatencyHistogram    latency;
+    std::atomic<size_t> failures   = 0;
+};
+
+uint64_t now() noexcept { return Event::now(); }
+
+// starts fn( index, latency ) on every thread at once and merges what they measured
+template< typename F >
+void run_threads( Result& result, size_t threads, uint64_t operations, F&& fn )
+{
+    result.threads    = threads;
+    result.operations = operations * threads;
+    std::vector<LatencyHistogram>   latencies( threads );
+    std::vector<uint64_t>           elapsed( threads );
+    std::barrier                    start( static_cast<ptrdiff_t>( threads ) );
+
+    std::vector<std::thread> workers;
+    for( size_t i = 0; i < threads; ++i )
+    {
+        workers.emplace_back( [&, i]
+        {
+            start.arrive_and_wait();
+            const auto begin = now();
+            fn( i, latencies[i] );
+            elapsed[i] = now() - begin;
+        } );
+    }
+    for( auto& worker : workers ) worker.join();
+
+    for( size_t i = 0; i < threads; ++i )
+    {
+        result.elapsed = std::max( result.elapsed, elapsed[i] );
+        for( size_t b = 0; b < LatencyHistogram::BUCKETS; ++b ) result.latency.counts[b] += latencies[i].counts[b];
+    }
+}
+
+template< typename F >
+void timed( LatencyHistogram& latency, F&& fn )
+{
+    const auto begin = now();
+    fn();
+    ++latency.counts[LatencyHistogram::bucket( now() - begin )];
+}
+
+void report( const char* name, const Result& result )
+{
+    const auto seconds = static_cast<double>( std::max<uint64_t>( result.elapsed, 1 ) ) * 1e-9;
+    std::printf( "%-28s %3zu threads %12.0f ops/s   p50 %6llu ns   p99 %7llu ns   p99.9 %8llu ns\n", name, result.threads,
+                 static_cast<double>( result.operations ) / seconds,
+                 static_cast<unsigned long long>( result.latency.quantile( 0.5 ) ),
+                 static_cast<unsigned long long>( result.latency.quantile( 0.99 ) ),
+                 static_cast<unsigned long long>( result.latency.quantile( 0.999 ) ) );
+}
+
+// 1, 2, 4 ... up to twice the hardware threads so oversubscription is covered as well
+std::vector<size_t> thread_counts()
+{
+    std::vector<size_t> counts;
+    for( size_t n = 1; n <= std::max<size_t>( 2 * utils::num_threads(), 2 ); n *= 2 ) counts.push_back( n );
+    return counts;
+}
+
+// every thread copies, assigns and drops references to the same few objects
+void hammer_refcounts( Result& result, size_t threads, uint64_t operations, bool measure )
+{
+    std::array<ref_ptr<Tracked>, 4> shared{ Tracked::create( 0 ), Tracked::create( 1 ), Tracked::create( 2 ), Tracked::create( 3 ) };
+
+    run_threads( result, threads, operations, [&]( size_t index, LatencyHistogram& latency )
+    {
+        ref_ptr<Tracked> local;
+        for( uint64_t i = 0; i < operations; ++i )
+        {
+            auto step = [&]
+            {
+                ref_ptr<Tracked> copy( shared[( index + i ) % shared.size()] );
+                local = copy;
+                local = shared[( index + i + 1 ) % shared.size()].get();
+            };
+            if( measure ) timed( latency, step ); else step();
+        }
+    } );
+
+    for( auto& object : shared ) if( object->ref_count() != 1 ) result.failures.fetch_add( 1 );
+}
+
+// one owner publishes a new object per step and retires old ones once no reader can still load them,
+// readers turn the published spy_ptr into a reference and drop it again
+void publish_retire( Result& result, size_t readers, uint64_t operations, bool measure )
+{
+    constexpr uint64_t IDLE = UINT64_MAX;
+
+    std::atomic<Tracked*>               published = nullptr;
+    std::atomic<uint64_t>               epoch     = 0;
+    std::atomic_bool                    stop      = false;
+    std::vector<std::atomic<uint64_t>>  announced( readers );
+    std::deque<ref_ptr<Tracked>>        owned;
+    for( auto& value : announced ) value.store( IDLE, std::memory_order_relaxed );
+
+    owned.push_back( Tracked::create( 0 ) );
+    published.store( owned.back().get() );
+
+    // a reader announces the epoch before loading, so every generation it may see is at least that old
+    std::thread owner( [&]
+    {
+        for( uint64_t generation = 1; !stop.load( std::memory_order_relaxed ); ++generation )
+        {
+            owned.push_back( Tracked::create( generation ) );
+            published.store( owned.back().get() );
+            epoch.store( generation );
+
+            auto oldest = generation;
+            for( auto& value : announced ) oldest = std::min( oldest, value.load() );
+            while( owned.front()->value < oldest ) owned.pop_front();
+            std::this_thread::yield();
+        }
+    } );
+
+    run_threads( result, readers, operations, [&]( size_t index, LatencyHistogram& latency )
+    {
+        uint64_t last = 0;
+        for( uint64_t i = 0; i < operations; ++i )
+        {
+            auto step = [&]
+            {
+                announced[index].store( epoch.load() );
+                auto reference = spy_ptr<Tracked>( published.load() ).load();
+                if( reference->value < last ) result.failures.fetch_add( 1, std::memory_order_relaxed );
+                last = reference->value;
+            };
+            if( measure ) timed( latency, step ); else step();
+            announced[index].store( IDLE );
+        }
+    } );
+
+    stop.store( true );
+    owner.join();
+}
+
+// every producer sends numbered events, the consumer checks each producer's order survived
+void send_events( Result& result, size_t producers, uint64_t operations, bool measure )
+{
+    Sink                    sink( 256 );
+    std::vector<uint32_t>   expected( producers, 0 );
+    uint64_t                received = 0;
+
+    std::thread consumer( [&]
+    {
+        while( received < producers * operations )
+        {
+            const auto polled = sink.PollEvents( [&]( Event& event )
+            {
+                auto& ping = static_cast<Ping&>( event );
+                if( ping.sequence != expected[ping.producer] ) result.failures.fetch_add( 1, std::memory_order_relaxed );
+                expected[ping.producer] = ping.sequence + 1;
+            } );
+            received += polled;
+            if( !polled ) std::this_thread::yield();
+        }
+    } );
+
+    run_threads( result, producers, operations, [&]( size_t index, LatencyHistogram& latency )
+    {
+        for( uint32_t i = 0; i < operations; ++i )
+        {
+            auto step = [&]
+            {
+                if( !sink.SendEvent( Ping::create( static_cast<uint32_t>( index ), i ) ) ) result.failures.fetch_add( 1, std::memory_order_relaxed );
+            };
+            if( measure ) timed( latency, step ); else step();
+        }
+    } );
+
+    consumer.join();
+    for( auto count : expected ) if( count != operations ) result.failures.fetch_add( 1 );
+}
+
+} // namespace
+
+TEST_CASE( "ref_ptr copies and assignments keep counts exact under contention", "[concurrency]" )
+{
+    const auto alive = Tracked::alive.load();
+    Result result;
+    hammer_refcounts( result, 4, 20000, false );
+    CHECK( result.failures.load() == 0 );
+    CHECK( Tracked::alive.load() == alive );
+}
+
+TEST_CASE( "spy_ptr loads stay valid while the owner publishes and retires", "[concurrency]" )
+{
+    const auto alive = Tracked::alive.load();
+    Result result;
+    publish_retire( result, 4, 20000, false );
+    CHECK( result.failures.load() == 0 );
+    CHECK( Tracked::alive.load() == alive );
+}
+
+TEST_CASE( "SendEvent from many producers keeps every producer's order", "[concurrency]" )
+{
+    Result result;
+    send_events( result, 4, 5000, false );
+    CHECK( result.failures.load() == 0 );
+}
+
+TEST_CASE( "refcount and event path scalability", "[.][benchmark][concurrency]" )
+{
+    using benchmark_t = void(*)( Result&, size_t, uint64_t, bool );
+    const std::array<std::tuple<const char*, benchmark_t, uint64_t>, 3> benchmarks
+    {{
+        { "ref_ptr copy/assign",  &hammer_refcounts, 200000 },
+        { "spy_ptr publish/load", &publish_retire,   200000 },
+        { "SendEvent",            &send_events,      100000 },
+    }};
+
+    for( auto [name, benchmark, operations] : benchmarks )
+    {
+        for( auto threads : thread_counts() )
+        {
+            Result result;
+            benchmark( result, threads, operations, true );
+            CHECK( result.failures.load() == 0 );
+            report( name, result );
+        }
+    }
+}
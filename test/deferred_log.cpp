@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/deferred_log.h>
+
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace aer;
+
+namespace
+{
+
+// messages of this test as ( thread, index ) in the order loguru received them
+struct Captured
+{
+    std::mutex                                      mutex;
+    std::vector<std::pair<unsigned, unsigned>>      messages;
+
+    size_t size() { std::scoped_lock lock( mutex ); return messages.size(); }
+};
+
+void capture( void* user_data, const loguru::Message& message )
+{
+    auto  text = std::strstr( message.message, "deferred test " );
+    if( !text ) return;
+
+    unsigned thread = 0, index = 0;
+    char     tag    = 0;
+    if( std::sscanf( text, "deferred test %u %u %c", &thread, &index, &tag ) != 3 || tag != 'x' ) return;
+
+    auto& captured = *static_cast<Captured*>( user_data );
+    std::scoped_lock lock( captured.mutex );
+    captured.messages.emplace_back( thread, index );
+}
+
+void log_messages( unsigned thread, unsigned first, unsigned count )
+{
+    // a plain char is a value like any other, only char pointers are refused
+    for( unsigned i = first; i < first + count; ++i ) DEFERRED_LOG_IF_F( INFO, true, "deferred test %u %u %c", thread, i, 'x' );
+}
+
+} // namespace
+
+TEST_CASE( "messages from several threads are all written by flush and shutdown", "[log]" )
+{
+    constexpr unsigned THREADS = 4, MESSAGES = 200;
+    static_assert( MESSAGES < DeferredLog::RING_CAPACITY );
+
+    Captured captured;
+    loguru::add_callback( "deferred_log_test", capture, &captured, loguru::Verbosity_INFO );
+    const auto dropped = DeferredLog::dropped();
+
+    std::vector<std::thread> threads;
+    for( unsigned t = 0; t < THREADS; ++t ) threads.emplace_back( log_messages, t, 0, MESSAGES );
+    for( auto& thread : threads ) thread.join();
+
+    // the rings outlive their threads, whatever the background thread has not written yet is flushed here
+    DeferredLog::flush();
+    CHECK( DeferredLog::dropped() == dropped );
+    REQUIRE( captured.size() == THREADS * MESSAGES );
+
+    // every thread's messages arrive once and in order
+    std::vector<unsigned> next( THREADS, 0 );
+    for( auto [thread, index] : captured.messages )
+    {
+        REQUIRE( thread < THREADS );
+        CHECK( index == next[thread]++ );
+    }
+
+    // shutdown writes what is still buffered, later messages are written before log() returns
+    log_messages( 0, MESSAGES, MESSAGES );
+    DeferredLog::shutdown();
+    CHECK( captured.size() == ( THREADS + 1 ) * MESSAGES );
+
+    log_messages( 1, MESSAGES, 1 );
+    CHECK( captured.size() == ( THREADS + 1 ) * MESSAGES + 1 );
+
+    loguru::remove_callback( "deferred_log_test" );
+}
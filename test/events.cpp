@@ -0,0 +1,213 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/Base.h>
+#include <Base/EventBus.h>
+#include <Base/EventListener.h>
+#include <Base/EventStorage.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace aer;
+
+namespace
+{
+
+struct Value : public inherit<Value, Event>
+{
+    Value( uint32_t in_key, uint32_t in_value ) : key( in_key ), value( in_value ) {}
+
+    uint32_t key;
+    uint32_t value;
+};
+
+// too large for the inline buffer, counts destructions so a leak or double destruction shows up
+struct Large : public inherit<Large, Event>
+{
+    static inline std::atomic<int64_t> alive = 0;
+
+    explicit Large( uint8_t fill ) { payload.fill( fill ); alive++; }
+            ~Large() { alive--; }
+
+    std::array<uint8_t, 2 * EventStorage::INLINE_SIZE> payload;
+};
+
+struct Listener : public IEventListener<Listener>
+{
+    explicit Listener( size_t capacity, EventOverflowPolicy policy = EVENT_OVERFLOW_DEFAULT ) : IEventListener( capacity ) { overflowPolicy = policy; }
+
+    size_t PendingEvents() const noexcept { return _events.size(); }
+
+    // values of every polled event in delivery order
+    std::vector<uint32_t> Poll()
+    {
+        std::vector<uint32_t> values;
+        PollEvents( [&]( Event& event ){ values.push_back( static_cast<Value&>( event ).value ); } );
+        return values;
+    }
+};
+
+} // namespace
+
+TEST_CASE( "a full listener drops the newest event or blocks the sender", "[events][overflow]" )
+{
+    constexpr size_t CAPACITY = 4;
+
+    SECTION( "drop newest" )
+    {
+        Listener listener( CAPACITY, EVENT_OVERFLOW_DROP_NEWEST );
+        for( uint32_t i = 0; i < CAPACITY; ++i ) CHECK( listener.SendEvent( Value::create( 0, i ) ) );
+        CHECK_FALSE( listener.SendEvent( Value::create( 0, 100 ) ) );
+        CHECK_FALSE( listener.EmplaceEvent<Value>( 0, 101 ) );
+        CHECK( listener.DroppedEvents() == 2 );
+
+        // the queued events are untouched, later ones fit again once they are consumed
+        CHECK( listener.Poll() == std::vector<uint32_t>{ 0, 1, 2, 3 } );
+        CHECK( listener.EmplaceEvent<Value>( 0, 4 ) );
+        CHECK( listener.Poll() == std::vector<uint32_t>{ 4 } );
+    }
+
+    SECTION( "block" )
+    {
+        constexpr uint32_t EVENTS = 100;
+
+        Listener             listener( CAPACITY, EVENT_OVERFLOW_BLOCK );
+        std::atomic<size_t>  sent     = 0;
+        std::atomic<size_t>  failures = 0;
+        std::thread producer( [&]
+        {
+            for( uint32_t i = 0; i < EVENTS; ++i )
+            {
+                if( !listener.EmplaceEvent<Value>( 0, i ) ) failures++;
+                sent++;
+            }
+        } );
+
+        // the producer fills the queue and then waits for the consumer instead of dropping
+        while( sent.load() < CAPACITY ) std::this_thread::yield();
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+        CHECK( sent.load() == CAPACITY );
+        CHECK( listener.PendingEvents() == CAPACITY );
+
+        std::vector<uint32_t> received;
+        while( received.size() < EVENTS )
+        {
+            auto values = listener.Poll();
+            received.insert( received.end(), values.begin(), values.end() );
+            if( values.empty() ) std::this_thread::yield();
+        }
+        producer.join();
+
+        CHECK( failures.load() == 0 );
+        CHECK( listener.DroppedEvents() == 0 );
+        for( uint32_t i = 0; i < EVENTS; ++i ) CHECK( received[i] == i );
+    }
+}
+
+TEST_CASE( "events larger than the inline buffer fall back to the heap", "[events][storage]" )
+{
+    static_assert(  EventStorage::fits_inline<Value> );
+    static_assert( !EventStorage::fits_inline<Large> );
+
+    const auto alive = Large::alive.load();
+    {
+        EventStorage small( std::in_place_type<Value>, 1u, 2u );
+        EventStorage large( std::in_place_type<Large>, uint8_t( 7 ) );
+        CHECK( small.is_inline() );
+        CHECK_FALSE( large.is_inline() );
+        CHECK( static_cast<Value&>( *small ).value == 2 );
+        CHECK( static_cast<Large&>( *large ).payload.back() == 7 );
+        CHECK( Large::alive.load() == alive + 1 );
+    }
+    CHECK( Large::alive.load() == alive );
+
+    // through a listener the payload arrives intact and is destroyed once the batch has been handed out
+    Listener listener( 8 );
+    REQUIRE( listener.EmplaceEvent<Large>( uint8_t( 3 ) ) );
+    REQUIRE( listener.EmplaceEvent<Value>( 0u, 5u ) );
+
+    size_t matching = 0;
+    listener.PollEvents( [&]( Event& event )
+    {
+        if( auto large = aer::cast<Large>( &event ) ) matching += std::all_of( large->payload.begin(), large->payload.end(), []( uint8_t b ){ return b == 3; } );
+        else if( auto value = aer::cast<Value>( &event ) ) matching += value->value == 5;
+    } );
+    CHECK( matching == 2 );
+    CHECK( Large::alive.load() == alive );
+}
+
+TEST_CASE( "coalescing keeps the last value per key in send order", "[events][coalescing]" )
+{
+    Listener listener( 16 );
+
+    SECTION( "newest wins" )
+    {
+        listener.Coalesce<Value>( []( const Value& event ) -> uint64_t { return event.key; } );
+    }
+    SECTION( "older values merged into the newest" )
+    {
+        // the merge keeps the newest value, so the outcome matches plain coalescing
+        listener.Coalesce<Value>( []( const Value& event ) -> uint64_t { return event.key; }, []( Value& newer, Value& older ){ CHECK( older.value < newer.value ); } );
+    }
+
+    // key 1: 10, 12, 15  key 2: 11, 14  key 3: 13
+    const std::pair<uint32_t, uint32_t> sent[] = { { 1, 10 }, { 2, 11 }, { 1, 12 }, { 3, 13 }, { 2, 14 }, { 1, 15 } };
+    for( auto [key, value] : sent ) REQUIRE( listener.EmplaceEvent<Value>( key, value ) );
+
+    // survivors keep their relative order
+    CHECK( listener.Poll() == std::vector<uint32_t>{ 13, 14, 15 } );
+
+    // coalescing only spans one batch
+    REQUIRE( listener.EmplaceEvent<Value>( 1u, 16u ) );
+    CHECK( listener.Poll() == std::vector<uint32_t>{ 16 } );
+}
+
+TEST_CASE( "the bus serves higher lanes first and keeps each channel in post order", "[events][bus]" )
+{
+    constexpr uint32_t EVENTS = 8;
+
+    // one worker runs the channels one after another; this thread never waits on the jobs, so it takes none
+    utils::JobCounter blocker;
+    utils::JobSystem  jobs( 1 );
+    EventBus          bus( jobs );
+
+    std::mutex                                      mutex;
+    std::vector<std::pair<EventLane, uint32_t>>     delivered;
+    auto attach = [&]( EventLane lane )
+    {
+        return bus.Attach( [&, lane]( Event& event )
+        {
+            std::scoped_lock lock( mutex );
+            delivered.emplace_back( lane, static_cast<Value&>( event ).value );
+        }, lane );
+    };
+    auto low    = attach( EVENT_LANE_LOW );
+    auto normal = attach( EVENT_LANE_NORMAL );
+    auto high   = attach( EVENT_LANE_HIGH );
+
+    // all three channels become ready while the worker is busy
+    std::atomic_bool release = false;
+    jobs.run( blocker, [&]{ while( !release.load() ) std::this_thread::yield(); } );
+    for( uint32_t i = 0; i < EVENTS; ++i )
+    {
+        REQUIRE( bus.Emplace<Value>( *low,    0u, i ) );
+        REQUIRE( bus.Emplace<Value>( *normal, 0u, i ) );
+        REQUIRE( bus.Emplace<Value>( *high,   0u, i ) );
+    }
+    release = true;
+
+    auto count = [&]{ std::scoped_lock lock( mutex ); return delivered.size(); };
+    while( count() < 3 * EVENTS ) std::this_thread::yield();
+
+    std::scoped_lock lock( mutex );
+    for( uint32_t i = 0; i < 3 * EVENTS; ++i )
+    {
+        CHECK( delivered[i].first  == static_cast<EventLane>( i / EVENTS ) );
+        CHECK( delivered[i].second == i % EVENTS );
+    }
+}
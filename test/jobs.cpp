@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/JobSystem.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace aer;
+
+TEST_CASE( "parallel_for visits every index once in chunks of grain", "[jobs]" )
+{
+    utils::JobSystem jobs( 3 );
+
+    constexpr size_t COUNT = 1000;
+    std::vector<std::atomic<uint32_t>> visits( COUNT );
+    std::atomic<size_t>                calls = 0;
+
+    SECTION( "grain below the range" )  { jobs.parallel_for( 0, COUNT, 7, [&]( size_t i ){ visits[i]++; calls++; } ); }
+    SECTION( "grain above the range" )  { jobs.parallel_for( 0, COUNT, 2 * COUNT, [&]( size_t i ){ visits[i]++; calls++; } ); }
+    SECTION( "zero grain" )             { jobs.parallel_for( 0, COUNT, 0, [&]( size_t i ){ visits[i]++; calls++; } ); }
+
+    CHECK( calls == COUNT );
+    CHECK( std::all_of( visits.begin(), visits.end(), []( auto& count ){ return count == 1; } ) );
+
+    // an offset range only visits its own indices
+    jobs.parallel_for( 10, 20, 3, [&]( size_t i ){ visits[i]++; } );
+    CHECK( visits[9] == 1 );
+    CHECK( visits[10] == 2 );
+    CHECK( visits[19] == 2 );
+    CHECK( visits[20] == 1 );
+}
+
+TEST_CASE( "parallel_for over an empty or reversed range invokes nothing", "[jobs]" )
+{
+    utils::JobSystem jobs( 2 );
+
+    size_t calls = 0;
+    jobs.parallel_for( 5, 5, 1, [&]( size_t ){ ++calls; } );
+    jobs.parallel_for( 9, 3, 1, [&]( size_t ){ ++calls; } );
+    CHECK( calls == 0 );
+}
+
+TEST_CASE( "run_after starts once the dependency has finished", "[jobs]" )
+{
+    utils::JobCounter dependency, counter;
+    utils::JobSystem  jobs( 3 );
+
+    constexpr size_t JOBS = 16;
+    std::atomic<size_t> finished = 0;
+    std::atomic<size_t> seen     = 0;
+
+    for( size_t i = 0; i < JOBS; ++i )
+    {
+        jobs.run( dependency, [&]{ std::this_thread::sleep_for( std::chrono::microseconds( 200 ) ); finished++; } );
+    }
+    jobs.run_after( dependency, counter, [&]{ seen = finished.load(); } );
+
+    jobs.wait( counter );
+    CHECK( dependency.pending() == 0 );
+    CHECK( seen == JOBS );
+
+    // a dependency without pending jobs does not hold the continuation back
+    bool ran = false;
+    jobs.run_after( dependency, counter, [&]{ ran = true; } );
+    jobs.wait( counter );
+    CHECK( ran );
+}
+
+TEST_CASE( "a worker whose deque is full runs further jobs inline", "[jobs]" )
+{
+    constexpr size_t EXTRA = 10;
+
+    // the counters outlive the system, whose workers may still be finishing them when it is destroyed
+    utils::JobCounter outer, inner;
+    utils::JobSystem  jobs( 1 );
+
+    // only touched by the single worker, and nothing steals from it while this thread stays out of wait()
+    bool   submitting = false;
+    size_t inlined    = 0;
+    std::atomic<size_t> ran = 0;
+
+    jobs.run( outer, [&]
+    {
+        submitting = true;
+        for( size_t i = 0; i < utils::JobDeque::CAPACITY + EXTRA; ++i )
+        {
+            jobs.run( inner, [&]{ if( submitting ) ++inlined; ran++; } );
+        }
+        submitting = false;
+    } );
+
+    while( outer.pending() > 0 || inner.pending() > 0 ) std::this_thread::yield();
+    CHECK( ran == utils::JobDeque::CAPACITY + EXTRA );
+    CHECK( inlined == EXTRA );
+}
+
+TEST_CASE( "wait runs jobs until the counter drops to zero, also from inside a job", "[jobs][concurrency]" )
+{
+    utils::JobCounter counter;
+    utils::JobSystem  jobs( 2 );
+
+    constexpr size_t OUTER = 8, INNER = 64;
+    std::atomic<size_t> done = 0;
+
+    for( size_t i = 0; i < OUTER; ++i )
+    {
+        jobs.run( counter, [&]
+        {
+            // nested waits must not deadlock when every worker is inside one
+            jobs.parallel_for( 0, INNER, 4, [&]( size_t ){ done++; } );
+        } );
+    }
+    jobs.wait( counter );
+
+    CHECK( counter.pending() == 0 );
+    CHECK( done == OUTER * INNER );
+}
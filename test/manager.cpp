@@ -0,0 +1,141 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/memory/Manager.h>
+#include <Base/memory/MemoryBlock.h>
+
+#include <new>
+#include <vector>
+
+using namespace aer;
+
+namespace
+{
+
+// an affinity nothing else allocates from, so its account only sees this test's allocator
+constexpr auto AFFINITY   = static_cast<mem::AllocatorAffinity>( 7 );
+constexpr auto BLOCK_SIZE = mem::MemoryBlock::DEFAULT_BLOCK_SIZE;
+
+// larger than half a block, so every allocation grows its own block
+constexpr size_t ALLOCATION = BLOCK_SIZE / 2 + BLOCK_SIZE / 8;
+
+struct Pressure
+{
+    mem::MemoryPressure     pressure;
+    size_t                  used;
+};
+
+} // namespace
+
+TEST_CASE( "Manager accounts, budgets and trims the allocators it is attached to", "[allocator][manager]" )
+{
+    auto& manager = mem::Manager::instance();
+    CHECK( mem::Allocator::instance().manager() == &manager );
+
+    mem::Allocator allocator;
+    allocator.policy = mem::ALLOCATOR_POLICY_AER_ALLOC_DEALLOC;
+
+    // memory taken before attaching is accounted
+    const auto base  = manager.used( AFFINITY );
+    auto       first = allocator.allocate( ALLOCATION, AFFINITY );
+    REQUIRE( allocator.backing_size( AFFINITY ) == BLOCK_SIZE );
+    CHECK( manager.used( AFFINITY ) == base );
+
+    REQUIRE( manager.attach( allocator ) );
+    CHECK( allocator.manager() == &manager );
+    CHECK( manager.used( AFFINITY ) == base + BLOCK_SIZE );
+
+    std::vector<Pressure> raised;
+    std::vector<void*>    freeable{ first };
+    auto callback = manager.add_pressure_callback( [&]( mem::AllocatorAffinity affinity, mem::MemoryPressure pressure, size_t used )
+    {
+        if( affinity != AFFINITY ) return;
+        raised.push_back( { pressure, used } );
+
+        // hard pressure frees an allocation, the Manager then trims its block before refusing
+        if( pressure == mem::MEMORY_PRESSURE_HARD && !freeable.empty() )
+        {
+            allocator.deallocate( freeable.back(), ALLOCATION );
+            freeable.pop_back();
+        }
+    } );
+
+    manager.set_budget( AFFINITY, { base + BLOCK_SIZE, base + 2 * BLOCK_SIZE } );
+
+    SECTION( "growth past the soft budget raises soft pressure once" )
+    {
+        auto second = allocator.allocate( ALLOCATION, AFFINITY );
+        CHECK( manager.used( AFFINITY ) == base + 2 * BLOCK_SIZE );
+        CHECK( manager.pressure( AFFINITY ) == mem::MEMORY_PRESSURE_SOFT );
+        REQUIRE( raised.size() == 1 );
+        CHECK( raised[0].pressure == mem::MEMORY_PRESSURE_SOFT );
+        CHECK( raised[0].used == base + 2 * BLOCK_SIZE );
+
+        // trimming back below the soft budget clears the pressure
+        allocator.deallocate( second, ALLOCATION );
+        CHECK( allocator.trim( AFFINITY ) == BLOCK_SIZE );
+        CHECK( manager.used( AFFINITY ) == base + BLOCK_SIZE );
+        CHECK( manager.pressure( AFFINITY ) == mem::MEMORY_PRESSURE_NONE );
+    }
+
+    SECTION( "hard pressure trims the memory callbacks free before growth is refused" )
+    {
+        auto second = allocator.allocate( ALLOCATION, AFFINITY );
+        auto third  = allocator.allocate( ALLOCATION, AFFINITY );
+        // soft pressure comes back once the trimmed memory has been reserved again
+        REQUIRE( raised.size() == 3 );
+        CHECK( raised[1].pressure == mem::MEMORY_PRESSURE_HARD );
+        CHECK( raised[2].pressure == mem::MEMORY_PRESSURE_SOFT );
+        CHECK( freeable.empty() );
+        CHECK( manager.used( AFFINITY ) == base + 2 * BLOCK_SIZE );
+        CHECK( allocator.backing_size( AFFINITY ) == 2 * BLOCK_SIZE );
+
+        // nothing left to free, so growth is refused
+        CHECK_THROWS_AS( allocator.allocate( ALLOCATION, AFFINITY ), std::bad_alloc );
+        CHECK( raised.back().pressure == mem::MEMORY_PRESSURE_HARD );
+        CHECK( manager.used( AFFINITY ) == base + 2 * BLOCK_SIZE );
+
+        allocator.deallocate( second, ALLOCATION );
+        allocator.deallocate( third,  ALLOCATION );
+        freeable.clear();
+    }
+
+    manager.remove_pressure_callback( callback );
+    manager.set_budget( AFFINITY, {} );
+    for( auto ptr : freeable ) allocator.deallocate( ptr, ALLOCATION );
+
+    // detaching gives the allocator's memory back to the account
+    manager.detach( allocator );
+    CHECK( allocator.manager() == nullptr );
+    CHECK( manager.used( AFFINITY ) == base );
+}
+
+TEST_CASE( "Manager budgets only arenas of an allocator on the default policy", "[allocator][manager]" )
+{
+    auto& manager = mem::Manager::instance();
+
+    mem::Allocator allocator;
+    REQUIRE( allocator.policy == mem::ALLOCATOR_POLICY_DEFAULT );
+    REQUIRE( manager.attach( allocator ) );
+
+    const auto base = manager.used( AFFINITY );
+    manager.set_budget( AFFINITY, { base + BLOCK_SIZE, base + BLOCK_SIZE } );
+
+    // operator new takes no block, so the allocation is neither counted nor refused
+    auto ptr = allocator.allocate( 2 * BLOCK_SIZE, AFFINITY );
+    REQUIRE( ptr );
+    CHECK( manager.used( AFFINITY ) == base );
+    CHECK( manager.pressure( AFFINITY ) == mem::MEMORY_PRESSURE_NONE );
+    allocator.deallocate( ptr, 2 * BLOCK_SIZE );
+
+    // arenas reserve their capacity whatever the policy
+    auto arena = allocator.create_arena( BLOCK_SIZE, AFFINITY );
+    REQUIRE( arena );
+    CHECK( manager.used( AFFINITY ) == base + BLOCK_SIZE );
+    CHECK_FALSE( allocator.create_arena( BLOCK_SIZE, AFFINITY ) );
+
+    allocator.release_arena( arena );
+    CHECK( manager.used( AFFINITY ) == base );
+
+    manager.set_budget( AFFINITY, {} );
+    manager.detach( allocator );
+}
@@ -0,0 +1,294 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/nodes/FlatGraph.h>
+#include <Base/nodes/Group.h>
+#include <Base/nodes/IncrementalTraversal.h>
+#include <Base/nodes/ParallelTraversal.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace aer;
+
+namespace
+{
+
+struct Collector
+{
+    std::vector<Node*> visited;
+
+    void visit( Node& node ) { visited.push_back( &node ); }
+
+    bool saw( const Node* node ) const { return std::find( visited.begin(), visited.end(), node ) != visited.end(); }
+};
+
+std::vector<ref_ptr<Node>> make_nodes( size_t count )
+{
+    std::vector<ref_ptr<Node>> nodes;
+    for( size_t i = 0; i < count; ++i ) nodes.emplace_back( Node::create().get() );
+    return nodes;
+}
+
+// per thread clone, merged back into the original after a parallel traversal
+struct MergingCollector : public inherit<MergingCollector, Object>
+{
+    std::vector<Node*> visited;
+    size_t             merges = 0;
+
+    void visit( Node& node ) { visited.push_back( &node ); }
+
+    ref_ptr<MergingCollector> clone() const { return MergingCollector::create(); }
+    void merge( MergingCollector& other ) { visited.insert( visited.end(), other.visited.begin(), other.visited.end() ); ++merges; }
+};
+
+void collect_serial( Node& node, std::vector<Node*>& visited )
+{
+    visited.push_back( &node );
+    if( auto group = aer::cast<Group>( &node ) ) for( auto& child : *group->children() ) if( child ) collect_serial( *child, visited );
+}
+
+} // namespace
+
+TEST_CASE( "traverse_changed visits a subtree created before since and linked after it", "[nodes][incremental]" )
+{
+    auto root    = Group::create( 0 );
+    auto subtree = Group::create( 0 );
+    auto leaf    = Node::create();
+    auto other   = Node::create();
+    subtree->add( ref_ptr<Node>( leaf.get() ) );
+    root->add( ref_ptr<Node>( other.get() ) );
+
+    Collector first;
+    const auto since = traverse_changed( *root, first, 0 );
+    CHECK( first.saw( other.get() ) );
+
+    SECTION( "add" )
+    {
+        root->add( ref_ptr<Node>( subtree.get() ) );
+    }
+    SECTION( "set" )
+    {
+        root->set( 0, ref_ptr<Node>( subtree.get() ) );
+    }
+    SECTION( "assign" )
+    {
+        root->assign( { ref_ptr<Node>( subtree.get() ) } );
+    }
+
+    Collector second;
+    traverse_changed( *root, second, since );
+    CHECK( second.saw( root.get() ) );
+    CHECK( second.saw( subtree.get() ) );
+    CHECK( second.saw( leaf.get() ) );
+    CHECK_FALSE( second.saw( other.get() ) );
+}
+
+TEST_CASE( "ChildList edits share the chunks they do not touch", "[nodes][children]" )
+{
+    constexpr auto CHUNK = ChildList::CHUNK_SIZE;
+    const ChildList list( make_nodes( 2 * CHUNK + 2 ) );
+
+    // elements of a shared chunk have the same address in both versions
+    auto appended = list.push_back( ref_ptr<Node>( Node::create().get() ) );
+    CHECK( appended.size() == list.size() + 1 );
+    CHECK( &appended[0]         == &list[0] );
+    CHECK( &appended[CHUNK]     == &list[CHUNK] );
+    CHECK( &appended[2 * CHUNK] != &list[2 * CHUNK] );
+
+    auto replaced = list.set( CHUNK + 3, ref_ptr<Node>( Node::create().get() ) );
+    CHECK( replaced.size() == list.size() );
+    CHECK( &replaced[0]         == &list[0] );
+    CHECK( &replaced[CHUNK]     != &list[CHUNK] );
+    CHECK( &replaced[2 * CHUNK] == &list[2 * CHUNK] );
+    CHECK( replaced[CHUNK + 3].get() != list[CHUNK + 3].get() );
+    CHECK( replaced[CHUNK + 4].get() == list[CHUNK + 4].get() );
+
+    // a full last chunk is not copied, the new child starts a chunk of its own
+    const ChildList full( make_nodes( CHUNK ) );
+    auto grown = full.push_back( ref_ptr<Node>( Node::create().get() ) );
+    CHECK( &grown[CHUNK - 1] == &full[CHUNK - 1] );
+    CHECK( grown.size() == CHUNK + 1 );
+}
+
+TEST_CASE( "a children() snapshot stays unchanged while the group is edited", "[nodes][children]" )
+{
+    auto group = Group::create( 0 );
+    for( auto& child : make_nodes( 100 ) ) group->add( child );
+
+    const auto snapshot = group->children();
+    const std::vector<ref_ptr<Node>> expected( snapshot->begin(), snapshot->end() );
+
+    group->add( ref_ptr<Node>( Node::create().get() ) );
+    group->set( 10, ref_ptr<Node>( Node::create().get() ) );
+    CHECK( group->children()->size() == 101 );
+    CHECK( ( *group->children() )[10].get() != expected[10].get() );
+
+    group->assign( make_nodes( 3 ) );
+    CHECK( group->children()->size() == 3 );
+
+    REQUIRE( snapshot->size() == expected.size() );
+    CHECK( std::equal( snapshot->begin(), snapshot->end(), expected.begin(), []( auto& lhs, auto& rhs ){ return lhs.get() == rhs.get(); } ) );
+}
+
+TEST_CASE( "readers iterate children() while a writer edits the group", "[nodes][children][concurrency]" )
+{
+    constexpr size_t EDITS = 2000;
+
+    auto group = Group::create( 0 );
+    for( auto& child : make_nodes( 64 ) ) group->add( child );
+
+    // every version the writer publishes holds only non-null children, so a reader seeing null saw a torn list
+    std::atomic_bool    done     = false;
+    std::atomic<size_t> failures = 0;
+
+    std::vector<std::thread> readers;
+    for( size_t r = 0; r < 3; ++r )
+    {
+        readers.emplace_back( [&]
+        {
+            while( !done.load( std::memory_order_acquire ) )
+            {
+                auto   children = group->children();
+                size_t count    = 0;
+                for( auto& child : *children ) { if( !child || child->ref_count() == 0 ) failures.fetch_add( 1, std::memory_order_relaxed ); ++count; }
+                if( count != children->size() ) failures.fetch_add( 1, std::memory_order_relaxed );
+            }
+        } );
+    }
+
+    for( size_t i = 0; i < EDITS; ++i )
+    {
+        switch( i % 3 )
+        {
+            case 0:  group->add( ref_ptr<Node>( Node::create().get() ) ); break;
+            case 1:  group->set( i % group->children()->size(), ref_ptr<Node>( Node::create().get() ) ); break;
+            default: if( i % 300 == 2 ) group->assign( make_nodes( 64 ) ); break;
+        }
+    }
+    done.store( true, std::memory_order_release );
+    for( auto& reader : readers ) reader.join();
+
+    CHECK( failures.load() == 0 );
+}
+
+TEST_CASE( "a shared child is touched while the groups holding it are edited", "[nodes][concurrency]" )
+{
+    constexpr size_t EDITS = 2000;
+
+    auto shared = Node::create();
+    auto first  = Group::create( 0 );
+    auto second = Group::create( 0 );
+    first->add( ref_ptr<Node>( shared.get() ) );
+    second->add( ref_ptr<Node>( shared.get() ) );
+
+    // each group has its own editor, the child's parent links are changed by both while it propagates
+    std::thread toucher( [&]{ for( size_t i = 0; i < EDITS; ++i ) shared->touch(); } );
+    std::thread editor( [&]
+    {
+        for( size_t i = 0; i < EDITS; ++i )
+        {
+            if( i % 2 ) second->set( 0, ref_ptr<Node>( shared.get() ) );
+            else        second->assign( { ref_ptr<Node>( shared.get() ), ref_ptr<Node>( Node::create().get() ) } );
+        }
+    } );
+    for( size_t i = 0; i < EDITS; ++i )
+    {
+        first->add( ref_ptr<Node>( shared.get() ) );
+        if( i % 64 == 63 ) first->assign( { ref_ptr<Node>( shared.get() ) } );
+    }
+    toucher.join();
+    editor.join();
+
+    // once the edits are done both groups are still linked and see the child's next change
+    shared->touch();
+    CHECK( first->subtree_version()  == shared->version() );
+    CHECK( second->subtree_version() == shared->version() );
+    CHECK( first->version()  < shared->version() );
+    CHECK( second->version() < shared->version() );
+}
+
+TEST_CASE( "FlatGraph emits a shared child once and references it where it is reached again", "[nodes][flat]" )
+{
+    auto root   = Group::create( 0 );
+    auto left   = Group::create( 0 );
+    auto right  = Group::create( 0 );
+    auto shared = Group::create( 0 );
+    auto leaf   = Node::create();
+    shared->add( ref_ptr<Node>( leaf.get() ) );
+    left->add( ref_ptr<Node>( shared.get() ) );
+    right->add( ref_ptr<Node>( shared.get() ) );
+    root->assign( { ref_ptr<Node>( left.get() ), ref_ptr<Node>( right.get() ) } );
+
+    SECTION( "shared child" )
+    {
+        // root, left, shared, leaf, right, reference to shared
+        auto graph = FlatGraph::compile( ref_ptr<Node>( root.get() ) );
+        REQUIRE( graph->size() == 6 );
+        CHECK( graph->find( shared.get() ) == 2 );
+        CHECK( graph->node( 5 ) == shared.get() );
+        CHECK( graph->is_reference( 5 ) );
+        CHECK( graph->original( 5 ) == 2 );
+        CHECK( graph->child_count( 5 ) == 0 );
+        CHECK( graph->subtree_size( 4 ) == 2 );
+        CHECK( graph->parent( 5 ) == 4 );
+        CHECK_FALSE( graph->is_reference( 2 ) );
+    }
+
+    SECTION( "cycle" )
+    {
+        // the leaf's group links back to the root, compiling ends at the reference
+        shared->add( ref_ptr<Node>( root.get() ) );
+        auto graph = FlatGraph::compile( ref_ptr<Node>( root.get() ) );
+        REQUIRE( graph->size() == 7 );
+        CHECK( graph->node( 4 ) == root.get() );
+        CHECK( graph->is_reference( 4 ) );
+        CHECK( graph->original( 4 ) == 0 );
+        CHECK( graph->subtree_size( 0 ) == 7 );
+
+        size_t originals = 0;
+        graph->traverse( [&]( FlatGraph::index_t i ){ originals += !graph->is_reference( i ); } );
+        CHECK( originals == 5 );
+
+        // break the cycle so the groups are released
+        shared->assign( {} );
+    }
+}
+
+TEST_CASE( "traverse_parallel merges per thread visitors into the serial result", "[nodes][parallel]" )
+{
+    constexpr size_t WIDE = 300, GROUPS = 8;
+
+    // a wide root, each of whose groups holds a wide level of leaves and a shared one
+    auto root   = Group::create( 0 );
+    auto shared = Node::create();
+    for( size_t g = 0; g < GROUPS; ++g )
+    {
+        auto group = Group::create( 0 );
+        auto nodes = make_nodes( WIDE );
+        nodes.push_back( ref_ptr<Node>( shared.get() ) );
+        group->assign( std::move( nodes ) );
+        root->add( ref_ptr<Node>( group.get() ) );
+    }
+    for( auto& child : make_nodes( WIDE ) ) root->add( child );
+
+    std::vector<Node*> serial;
+    collect_serial( *root, serial );
+
+    utils::JobSystem jobs( 3 );
+    TraversalOptions options;
+    SECTION( "grain below the child count" ) { options.grain = 16; }
+    SECTION( "grain above the child count" ) { options.grain = 4 * WIDE; }
+
+    auto visitor = MergingCollector::create();
+    traverse_parallel( *root, *visitor, options, jobs );
+
+    // the original only sees what its clones merged back
+    CHECK( visitor->merges >= 1 );
+    REQUIRE( visitor->visited.size() == serial.size() );
+    std::sort( serial.begin(), serial.end() );
+    std::sort( visitor->visited.begin(), visitor->visited.end() );
+    CHECK( visitor->visited == serial );
+    CHECK( std::count( serial.begin(), serial.end(), shared.get() ) == GROUPS );
+}
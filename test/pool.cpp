@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/Base.h>
+
+#include <thread>
+#include <vector>
+
+using namespace aer;
+
+namespace
+{
+
+// every test case has its own type, so the process wide pool counters of one do not leak into another
+template< int TAG >
+struct Pooled : public inherit<Pooled<TAG>, Object>
+{
+    static constexpr std::size_t pool_capacity = 4;
+
+    uint64_t payload[4] = {};
+};
+
+// counter deltas since the snapshot was taken
+template< typename T >
+struct StatsDelta
+{
+    mem::ObjectPoolStats before = T::pool_stats();
+
+    mem::ObjectPoolStats operator () () const
+    {
+        auto now = T::pool_stats();
+        return { now.capacity, now.cached, now.hits - before.hits, now.misses - before.misses, now.recycled - before.recycled, now.released - before.released };
+    }
+};
+
+} // namespace
+
+TEST_CASE( "pooled objects reuse the storage of destroyed ones", "[pool]" )
+{
+    using T = Pooled<0>;
+    StatsDelta<T> delta;
+
+    const void* address = nullptr;
+    {
+        auto first = T::create();
+        address = first.get();
+    }
+    CHECK( delta().misses   == 1 );
+    CHECK( delta().recycled == 1 );
+    CHECK( delta().cached   == 1 );
+
+    auto second = T::create();
+    CHECK( second.get() == address );
+    CHECK( delta().hits   == 1 );
+    CHECK( delta().cached == 0 );
+}
+
+TEST_CASE( "a pool keeps at most its capacity on the freelist", "[pool]" )
+{
+    using T = Pooled<1>;
+    REQUIRE( T::pool_stats().capacity == T::pool_capacity );
+    T::set_pool_capacity( 2 );
+    StatsDelta<T> delta;
+
+    {
+        std::vector<ref_ptr<T>> objects;
+        for( size_t i = 0; i < 5; ++i ) objects.push_back( T::create() );
+        CHECK( delta().misses == 5 );
+    }
+    CHECK( delta().capacity == 2 );
+    CHECK( delta().cached   == 2 );
+    CHECK( delta().recycled == 2 );
+    CHECK( delta().released == 3 );
+
+    // a lower limit does not drop cached blocks, they are reused first
+    T::set_pool_capacity( 0 );
+    {
+        auto reused = T::create();
+        CHECK( delta().hits == 1 );
+    }
+    CHECK( delta().cached   == 1 );
+    CHECK( delta().released == 4 );
+
+    T::set_pool_capacity( T::pool_capacity );
+}
+
+TEST_CASE( "every thread recycles through its own freelist", "[pool][concurrency]" )
+{
+    using T = Pooled<2>;
+    StatsDelta<T> delta;
+
+    const void* address = nullptr;
+    {
+        auto object = T::create();
+        address = object.get();
+    }
+    REQUIRE( delta().cached == 1 );
+
+    // the block cached by this thread is not visible to another one, whose own cache goes upstream on exit
+    const void* other = nullptr;
+    std::thread thread( [&]
+    {
+        auto object = T::create();
+        other = object.get();
+        object = nullptr;
+
+        auto again = T::create();
+        CHECK( again.get() == other );
+    } );
+    thread.join();
+
+    CHECK( other != address );
+    CHECK( delta().misses   == 2 );
+    CHECK( delta().hits     == 1 );
+    CHECK( delta().recycled == 3 );
+    CHECK( delta().released == 1 );
+    CHECK( delta().cached   == 1 );
+
+    auto object = T::create();
+    CHECK( object.get() == address );
+}
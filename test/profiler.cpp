@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/Profiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace aer;
+
+namespace
+{
+
+struct TraceEvent
+{
+    std::string             name;
+    utils::thread_index_t   thread;
+    uint64_t                begin;  // nanoseconds, as recorded
+    uint64_t                end;
+};
+
+// parses the one event per line layout write_chrome_trace() produces, keeping events named prefix*
+std::vector<TraceEvent> export_trace( const std::string& prefix )
+{
+    std::ostringstream stream;
+    Profiler::write_chrome_trace( stream );
+
+    std::vector<TraceEvent> events;
+    std::istringstream      lines( stream.str() );
+    for( std::string line; std::getline( lines, line ); )
+    {
+        char               name[64] = {};
+        unsigned           thread   = 0;
+        unsigned long long ts = 0, tsFraction = 0, dur = 0, durFraction = 0;
+        if( std::sscanf( line.c_str(), "{\"name\":\"%63[^\"]\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%llu.%llu,\"dur\":%llu.%llu}", name, &thread, &ts, &tsFraction, &dur, &durFraction ) != 6 ) continue;
+        if( std::string( name ).rfind( prefix, 0 ) != 0 ) continue;
+
+        const auto begin = ts * 1000 + tsFraction;
+        events.push_back( { name, thread, begin, begin + dur * 1000 + durFraction } );
+    }
+    return events;
+}
+
+} // namespace
+
+TEST_CASE( "zones are exported as nested enter and exit pairs per thread", "[profiler]" )
+{
+    constexpr size_t THREADS = 4, ZONES = 100;
+
+    Profiler::clear();
+
+    // the threads stay alive until all of them have recorded, so none inherits the id and ring of another
+    std::vector<utils::thread_index_t> ids( THREADS );
+    std::barrier                       sync( THREADS );
+    std::vector<std::thread>           threads;
+    for( size_t t = 0; t < THREADS; ++t )
+    {
+        threads.emplace_back( [&, t]
+        {
+            ids[t] = utils::thread_id();
+            for( size_t i = 0; i < ZONES; ++i )
+            {
+                ProfileZone outer( "test.outer" );
+                ProfileZone inner( "test.inner" );
+            }
+            sync.arrive_and_wait();
+        } );
+    }
+    for( auto& thread : threads ) thread.join();
+
+    std::map<utils::thread_index_t, std::vector<TraceEvent>> perThread;
+    for( auto& event : export_trace( "test." ) ) perThread[event.thread].push_back( event );
+
+    REQUIRE( perThread.size() == THREADS );
+    for( auto id : ids )
+    {
+        auto& events = perThread[id];
+        CHECK( std::count_if( events.begin(), events.end(), []( auto& event ){ return event.name == "test.outer"; } ) == ZONES );
+        CHECK( std::count_if( events.begin(), events.end(), []( auto& event ){ return event.name == "test.inner"; } ) == ZONES );
+
+        // inner zones close first, so every inner is directly followed by the outer enclosing it
+        for( size_t i = 0; i + 1 < events.size(); i += 2 )
+        {
+            CHECK( events[i].name == "test.inner" );
+            CHECK( events[i + 1].name == "test.outer" );
+            CHECK( events[i + 1].begin <= events[i].begin );
+            CHECK( events[i].end <= events[i + 1].end );
+        }
+    }
+}
+
+TEST_CASE( "lapped ring entries are left out of the export", "[profiler]" )
+{
+    constexpr uint64_t EXTRA = 10, BASE = 1000;
+
+    Profiler::clear();
+
+    SECTION( "a full ring keeps the newest zones" )
+    {
+        constexpr uint64_t ZONES = Profiler::RING_CAPACITY + EXTRA;
+        for( uint64_t i = 0; i < ZONES; ++i ) Profiler::record( "lap.zone", BASE + i, BASE + i + 1 );
+
+        // the slot the next zone goes to is never exported
+        auto events = export_trace( "lap." );
+        REQUIRE( events.size() == Profiler::RING_CAPACITY - 1 );
+        CHECK( events.front().begin == BASE + ZONES - ( Profiler::RING_CAPACITY - 1 ) );
+        CHECK( events.back().begin  == BASE + ZONES - 1 );
+    }
+
+    SECTION( "entries overwritten during an export are skipped, never torn" )
+    {
+        // every zone lasts exactly one nanosecond, a torn entry mixes the begin and end of two zones
+        std::atomic<uint64_t> recorded = 0;
+        std::atomic_bool      done     = false;
+        std::thread writer( [&]
+        {
+            for( uint64_t i = 0; !done.load( std::memory_order_relaxed ); ++i )
+            {
+                Profiler::record( "lap.zone", BASE + i, BASE + i + 1 );
+                recorded.store( i + 1, std::memory_order_relaxed );
+            }
+        } );
+
+        // export only once the writer has lapped its ring, so every pass races with overwrites
+        while( recorded.load( std::memory_order_relaxed ) < 2 * Profiler::RING_CAPACITY ) std::this_thread::yield();
+
+        size_t torn = 0, exported = 0;
+        for( size_t pass = 0; pass < 20; ++pass )
+        {
+            for( auto& event : export_trace( "lap." ) ) { torn += event.end != event.begin + 1; ++exported; }
+        }
+        done = true;
+        writer.join();
+
+        CHECK( exported > 0 );
+        CHECK( torn == 0 );
+    }
+
+    Profiler::clear();
+}
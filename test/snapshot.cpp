@@ -0,0 +1,134 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/nodes/Snapshot.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace aer;
+
+namespace
+{
+
+std::filesystem::path snapshot_path( const char* name )
+{
+    return std::filesystem::temp_directory_path() / name;
+}
+
+std::vector<char> read_file( const std::filesystem::path& path )
+{
+    std::ifstream file( path, std::ios::binary );
+    return { std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() };
+}
+
+void write_file( const std::filesystem::path& path, const std::vector<char>& bytes )
+{
+    std::ofstream file( path, std::ios::binary | std::ios::trunc );
+    file.write( bytes.data(), bytes.size() );
+}
+
+const Group& as_group( const ref_ptr<Node>& node )
+{
+    auto group = aer::cast<Group>( node.get() );
+    REQUIRE( group );
+    return *group;
+}
+
+} // namespace
+
+TEST_CASE( "a snapshot written, mapped and materialized has the shape of the graph", "[nodes][snapshot]" )
+{
+    // root -> [ shared -> [ leaf ], other, shared, null ]
+    auto root   = Group::create( 0 );
+    auto shared = Group::create( 0 );
+    shared->add( ref_ptr<Node>( Node::create().get() ) );
+    root->assign( { ref_ptr<Node>( shared.get() ), ref_ptr<Node>( Node::create().get() ), ref_ptr<Node>( shared.get() ), ref_ptr<Node>() } );
+
+    const auto path = snapshot_path( "aer_snapshot_roundtrip.bin" );
+    REQUIRE( Snapshot::write( ref_ptr<Node>( root.get() ), path ) );
+
+    auto snapshot = Snapshot::map( path );
+    REQUIRE( snapshot );
+    CHECK( snapshot->header().nodeCount == 4 );
+    CHECK( snapshot->nodes()[snapshot->root()].type == aer::type_id<Group>() );
+    CHECK( snapshot->children( snapshot->root() ).size() == 4 );
+
+    SECTION( "from the root" )
+    {
+        auto  copy     = snapshot->materialize();
+        auto& group    = as_group( copy );
+        auto  children = group.children();
+        REQUIRE( children->size() == 4 );
+        CHECK( ( *children )[0].get() == ( *children )[2].get() );
+        CHECK( ( *children )[1]->type_id() == aer::type_id<Node>() );
+        CHECK_FALSE( ( *children )[3] );
+        CHECK( as_group( ( *children )[0] ).children()->size() == 1 );
+        CHECK( snapshot->materialize().get() == copy.get() );
+    }
+
+    SECTION( "a subtree first, the root reuses it" )
+    {
+        const auto index   = snapshot->children( snapshot->root() )[0];
+        auto       subtree = snapshot->materialize( index );
+        CHECK( as_group( subtree ).children()->size() == 1 );
+
+        auto copy = snapshot->materialize();
+        CHECK( ( *as_group( copy ).children() )[0].get() == subtree.get() );
+    }
+
+    snapshot = nullptr;
+    std::filesystem::remove( path );
+}
+
+TEST_CASE( "truncated and corrupt snapshots are rejected", "[nodes][snapshot]" )
+{
+    auto root = Group::create( 0 );
+    root->add( ref_ptr<Node>( Node::create().get() ) );
+
+    const auto path = snapshot_path( "aer_snapshot_corrupt.bin" );
+    REQUIRE( Snapshot::write( ref_ptr<Node>( root.get() ), path ) );
+    auto bytes = read_file( path );
+    REQUIRE( bytes.size() > sizeof( SnapshotHeader ) );
+
+    SECTION( "truncated header" )
+    {
+        bytes.resize( sizeof( SnapshotHeader ) / 2 );
+        write_file( path, bytes );
+        CHECK_FALSE( Snapshot::map( path ) );
+    }
+
+    SECTION( "truncated tables" )
+    {
+        bytes.resize( bytes.size() - sizeof( Snapshot::index_t ) );
+        write_file( path, bytes );
+        CHECK_FALSE( Snapshot::map( path ) );
+    }
+
+    SECTION( "wrong magic" )
+    {
+        bytes[0] ^= 0xFF;
+        write_file( path, bytes );
+        CHECK_FALSE( Snapshot::map( path ) );
+    }
+
+    SECTION( "child range past the children table" )
+    {
+        SnapshotHeader header;
+        std::memcpy( &header, bytes.data(), sizeof( header ) );
+
+        SnapshotNode record;
+        std::memcpy( &record, bytes.data() + header.nodesOffset, sizeof( record ) );
+        record.childCount = 1000;
+        std::memcpy( bytes.data() + header.nodesOffset, &record, sizeof( record ) );
+        write_file( path, bytes );
+
+        auto snapshot = Snapshot::map( path );
+        REQUIRE( snapshot );
+        CHECK_FALSE( snapshot->materialize() );
+    }
+
+    std::filesystem::remove( path );
+}
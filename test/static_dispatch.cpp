@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <Base/static_dispatch.h>
+#include <Base/nodes/FlatGraph.h>
+
+using namespace aer;
+
+namespace
+{
+
+struct DynamicVisitor;
+
+// the virtual double dispatch baseline
+struct Shape : public inherit<Shape, Node>
+{
+    virtual void accept_dynamic( DynamicVisitor& visitor ) = 0;
+};
+
+struct Circle;
+struct Square;
+struct Polygon;
+
+struct DynamicVisitor
+{
+    uint64_t sum = 0;
+    void visit( Circle&  );
+    void visit( Square&  );
+    void visit( Polygon& );
+};
+
+struct Circle : public inherit<Circle, Shape>
+{
+    uint64_t radius = 1;
+    void accept_dynamic( DynamicVisitor& visitor ) override { visitor.visit( *this ); }
+};
+
+struct Square : public inherit<Square, Shape>
+{
+    uint64_t side = 2;
+    void accept_dynamic( DynamicVisitor& visitor ) override { visitor.visit( *this ); }
+};
+
+struct Polygon : public inherit<Polygon, Shape>
+{
+    uint64_t corners = 5;
+    void accept_dynamic( DynamicVisitor& visitor ) override { visitor.visit( *this ); }
+};
+
+void DynamicVisitor::visit( Circle&  circle  ) { sum += circle.radius; }
+void DynamicVisitor::visit( Square&  square  ) { sum += square.side; }
+void DynamicVisitor::visit( Polygon& polygon ) { sum += polygon.corners; }
+
+struct StaticVisitor
+{
+    uint64_t sum    = 0;
+    uint64_t groups = 0;
+    void visit( Circle&  circle  ) { sum += circle.radius; }
+    void visit( Square&  square  ) { sum += square.side; }
+    void visit( Polygon& polygon ) { sum += polygon.corners; }
+    void visit( Group& )           { ++groups; }
+};
+
+using Shapes = type_list<Circle, Square, Polygon, Group>;
+
+ref_ptr<Node> make_graph( size_t groups, size_t shapes_per_group )
+{
+    auto root = Group::create( 0 );
+    for( size_t g = 0; g < groups; ++g )
+    {
+        auto group = Group::create( 0 );
+        for( size_t s = 0; s < shapes_per_group; ++s )
+        {
+            switch( ( g * 7 + s * 13 ) % 3 )
+            {
+                case 0:  group->add( ref_ptr<Node>( Circle::create().get() ) );  break;
+                case 1:  group->add( ref_ptr<Node>( Square::create().get() ) );  break;
+                default: group->add( ref_ptr<Node>( Polygon::create().get() ) ); break;
+            }
+        }
+        root->add( ref_ptr<Node>( group.get() ) );
+    }
+    return ref_ptr<Node>( root.get() );
+}
+
+uint64_t visit_static( const FlatGraph& graph )
+{
+    StaticVisitor visitor;
+    for( FlatGraph::index_t i = 0; i < graph.size(); ++i ) static_visit<Shapes>( *graph.node( i ), visitor );
+    return visitor.sum;
+}
+
+uint64_t visit_dynamic( const FlatGraph& graph )
+{
+    DynamicVisitor visitor;
+    for( FlatGraph::index_t i = 0; i < graph.size(); ++i )
+    {
+        if( auto shape = aer::cast<Shape>( graph.node( i ) ) ) shape->accept_dynamic( visitor );
+    }
+    return visitor.sum;
+}
+
+} // namespace
+
+TEST_CASE( "static dispatch resolves the most derived listed type", "[static_dispatch]" )
+{
+    StaticVisitor visitor;
+    auto circle = Circle::create();
+    auto group  = Group::create( 0 );
+
+    CHECK( static_visit<Shapes>( *circle, visitor ) );
+    CHECK( static_visit<Shapes>( *group, visitor ) );
+    CHECK( visitor.sum == 1 );
+    CHECK( visitor.groups == 1 );
+
+    // Node itself is not listed
+    auto node = Node::create();
+    CHECK_FALSE( static_visit<Shapes>( *node, visitor ) );
+
+    auto graph = FlatGraph::compile( make_graph( 16, 16 ) );
+    CHECK( visit_static( *graph ) == visit_dynamic( *graph ) );
+}
+
+TEST_CASE( "static dispatch against virtual double dispatch", "[.][benchmark][static_dispatch]" )
+{
+    auto graph = FlatGraph::compile( make_graph( 1024, 256 ) );
+
+    BENCHMARK( "static jump table" ) { return visit_static( *graph ); };
+    BENCHMARK( "virtual double dispatch" ) { return visit_dynamic( *graph ); };
+}
@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Base/thread_utils.h>
+
+#include <algorithm>
+#include <barrier>
+#include <thread>
+#include <vector>
+
+using namespace aer;
+
+TEST_CASE( "ThreadRegistry recycles released ids before minting new ones", "[threads]" )
+{
+    utils::ThreadRegistry registry;
+
+    const auto a = registry.acquire();
+    const auto b = registry.acquire();
+    const auto c = registry.acquire();
+    CHECK( std::vector{ a, b, c } == std::vector<utils::thread_index_t>{ 0, 1, 2 } );
+    CHECK( registry.active() == 3 );
+
+    registry.release( b );
+    CHECK( registry.acquire() == b );
+
+    // the free ids are a stack, the last released comes back first
+    registry.release( a );
+    registry.release( c );
+    CHECK( registry.active() == 1 );
+    CHECK( registry.acquire() == c );
+    CHECK( registry.acquire() == a );
+    CHECK( registry.size() == 3 );
+}
+
+TEST_CASE( "thread ids stay dense across waves of threads", "[threads][concurrency]" )
+{
+    constexpr size_t WAVES = 6, THREADS = 8;
+
+    // this thread keeps its id for the whole test
+    utils::thread_id();
+    auto&      registry = utils::ThreadRegistry::instance();
+    const auto before   = registry.size();
+
+    utils::thread_index_t size = 0;
+    for( size_t wave = 0; wave < WAVES; ++wave )
+    {
+        // every thread of a wave holds its id until all of them have one
+        std::vector<utils::thread_index_t> ids( THREADS );
+        std::barrier                       sync( THREADS );
+        std::vector<std::thread>           threads;
+        for( size_t i = 0; i < THREADS; ++i ) threads.emplace_back( [&, i]{ ids[i] = utils::thread_id(); sync.arrive_and_wait(); } );
+        for( auto& thread : threads ) thread.join();
+
+        std::sort( ids.begin(), ids.end() );
+        CHECK( std::adjacent_find( ids.begin(), ids.end() ) == ids.end() );
+        CHECK( ids.back() < registry.size() );
+
+        // the first wave may mint ids, later waves only reuse the ones it gave back
+        if( wave == 0 )
+        {
+            size = registry.size();
+            CHECK( size <= before + THREADS );
+        }
+        else CHECK( registry.size() == size );
+    }
+}